@@ -25,9 +25,15 @@ class app(ConanFile):
     settings = "compiler", "build_type", "os", "arch"
     options = {
         "platform": ["ANY"],
+        "log_level": [0, 1, 2, 3, 4],
+        "hardware_i2c": [True, False],
+        "profiling": ["auto", True, False],
     }
     default_options = {
         "platform": "unspecified",
+        "log_level": 2,
+        "hardware_i2c": False,
+        "profiling": "auto",
     }
 
     def set_version(self):
@@ -63,10 +69,25 @@ class app(ConanFile):
 
         tc = CMakeToolchain(self)
         tc.generator = "Ninja"
+        if self.options.platform == "host":
+            # Simulated hardware, see platforms/host.cpp
+            tc.cache_variables["E10_PLATFORM"] = "host"
         tc.generate()
 
     def build(self):
         cmake = CMake(self)
+        # Profiling zones are compiled out of release builds unless requested
+        profiling = str(self.options.profiling)
+        if profiling == "auto":
+            profiling = str(self.settings.build_type not in
+                            ["Release", "MinSizeRel"])
         cmake.configure()
-        cmake.configure(variables={"E10_ADAPTER_VERSION": str(self.version)})
-        cmake.build()
\ No newline at end of file
+        cmake.configure(variables={
+            "E10_ADAPTER_VERSION": str(self.version),
+            "E10_LOG_LEVEL": str(self.options.log_level),
+            "E10_HARDWARE_I2C": "1" if self.options.hardware_i2c else "0",
+            "E10_PROFILING": "1" if profiling == "True" else "0",
+        })
+        cmake.build()
+        if self.options.platform == "host":
+            cmake.test()
\ No newline at end of file
@@ -0,0 +1,60 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+
+#include <libhal/units.hpp>
+
+#include "diode_scanner.hpp"
+
+namespace e10 {
+/**
+ * @brief Direction of the beacon interpolated between the photo diodes
+ *
+ */
+struct bearing
+{
+  /// Number of fractional steps between two neighbouring diodes
+  static constexpr hal::u16 steps_per_diode = 256;
+
+  /// Direction as a fixed point diode index with 8 fractional bits. 0 is
+  /// diode 0 and `7 * steps_per_diode` is diode 7.
+  hal::u16 position = 0;
+  /// How much the result can be trusted, 0 (noise) to 255 (strong single
+  /// peak).
+  hal::u8 confidence = 0;
+  /// Index of the strongest diode the interpolation was centered on
+  hal::u8 peak = 0;
+};
+
+/**
+ * @brief Interpolate the beacon direction from the diode intensities
+ *
+ * A parabola is fit through the strongest diode and its two neighbours and the
+ * position of its vertex is returned. When the strongest diode is at either
+ * end of the array, the centroid of it and its only neighbour is used instead.
+ * When neighbouring diodes share the strongest intensity, the middle of that
+ * plateau is returned.
+ *
+ * Confidence is the prominence of the peak over the mean of the other diodes,
+ * scaled down linearly when the peak is below a quarter of full scale.
+ *
+ * @param p_intensity - 16-bit intensity of each diode
+ * @return bearing - interpolated direction and confidence
+ */
+bearing interpolate_bearing(
+  std::array<hal::u16, diode_count> const& p_intensity);
+}  // namespace e10
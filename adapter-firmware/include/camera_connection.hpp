@@ -0,0 +1,248 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+
+#include <libhal/steady_clock.hpp>
+#include <libhal/units.hpp>
+
+namespace e10 {
+/**
+ * @brief Tracks the camera connection and schedules reconnect attempts
+ *
+ * A reconnect is a knock followed, `knock_wait` later, by reading the
+ * camera's answer. Instead of blocking for that time, the main loop asks
+ * next_step() what to do whenever it is idle, and reports back with
+ * knock_sent() and knock_answered(). Failed attempts are retried after a
+ * backoff that doubles from `first_backoff` up to `max_backoff`, so a missing
+ * camera costs almost nothing while the adapter keeps answering commands.
+ *
+ * Switching the camera's algorithm works the same way. change_algorithm()
+ * asks for the change, which is sent once the camera is connected, and the
+ * camera's answer is read `algorithm_wait` after algorithm_sent(). The camera
+ * must not be read in between, see ready().
+ */
+class camera_connection
+{
+public:
+  /// Time the camera needs to answer a knock
+  static constexpr auto knock_wait = std::chrono::milliseconds(50);
+  /// Time the camera needs to answer an algorithm change
+  static constexpr auto algorithm_wait = std::chrono::milliseconds(50);
+  /// Wait before the first retry after a failed attempt
+  static constexpr auto first_backoff = std::chrono::milliseconds(100);
+  /// Longest wait between two attempts
+  static constexpr auto max_backoff = std::chrono::milliseconds(3200);
+
+  /// What the main loop should do for the connection
+  enum class step : hal::u8
+  {
+    /// Nothing for now
+    none,
+    /// Knock on the camera, then call knock_sent()
+    send_knock,
+    /// Read the answer to the knock, then call knock_answered()
+    read_knock,
+    /// Tell the camera to switch algorithms, then call algorithm_sent()
+    send_algorithm,
+    /// Read the answer to the algorithm change, then call
+    /// algorithm_answered()
+    read_algorithm,
+  };
+
+  /**
+   * @brief Construct a new camera connection that tries to connect right away
+   *
+   * @param p_clock - clock used to schedule the attempts
+   */
+  camera_connection(hal::steady_clock& p_clock)
+    : m_clock(&p_clock)
+  {
+    m_backoff = ticks(first_backoff);
+  }
+
+  /**
+   * @brief Determine if the camera can be used
+   *
+   * @return true - the last knock was answered and no transfer failed since
+   */
+  bool connected() const
+  {
+    return m_state == state::connected || m_state == state::switching;
+  }
+
+  /**
+   * @brief Determine if the camera can be read
+   *
+   * @return true - connected and no algorithm change is waiting to be sent or
+   * answered
+   */
+  bool ready() const
+  {
+    return m_state == state::connected && not m_change_requested;
+  }
+
+  /**
+   * @brief Step of the reconnect or algorithm change that is due
+   *
+   * @return step - what to do now, none while ready or waiting
+   */
+  step next_step() const
+  {
+    if (m_state == state::connected) {
+      return m_change_requested ? step::send_algorithm : step::none;
+    }
+    if (m_clock->uptime() < m_deadline) {
+      return step::none;
+    }
+    switch (m_state) {
+      case state::knocking:
+        return step::read_knock;
+      case state::switching:
+        return step::read_algorithm;
+      default:
+        return step::send_knock;
+    }
+  }
+
+  /**
+   * @brief Record that the knock was sent
+   *
+   */
+  void knock_sent()
+  {
+    m_state = state::knocking;
+    m_deadline = m_clock->uptime() + ticks(knock_wait);
+    m_attempts++;
+  }
+
+  /**
+   * @brief Record the outcome of a reconnect attempt
+   *
+   * @param p_accepted - the camera answered the knock with OK. Also false if
+   * the knock could not be sent.
+   */
+  void knock_answered(bool p_accepted)
+  {
+    if (p_accepted) {
+      m_state = state::connected;
+      m_backoff = ticks(first_backoff);
+      m_connects++;
+      return;
+    }
+    m_state = state::backing_off;
+    m_deadline = m_clock->uptime() + m_backoff;
+    m_backoff = std::min(m_backoff * 2, ticks(max_backoff));
+  }
+
+  /**
+   * @brief Ask for the camera to be switched to another algorithm
+   *
+   * The change is sent once the camera is connected. Asking again before the
+   * camera answered sends another change after the answer was read.
+   */
+  void change_algorithm()
+  {
+    m_change_requested = true;
+  }
+
+  /**
+   * @brief Drop an algorithm change that has not been sent yet
+   *
+   */
+  void cancel_algorithm_change()
+  {
+    m_change_requested = false;
+  }
+
+  /**
+   * @brief Record that the algorithm change was sent
+   *
+   */
+  void algorithm_sent()
+  {
+    m_state = state::switching;
+    m_deadline = m_clock->uptime() + ticks(algorithm_wait);
+    m_change_requested = false;
+  }
+
+  /**
+   * @brief Record that the answer to the algorithm change was read
+   *
+   */
+  void algorithm_answered()
+  {
+    m_state = state::connected;
+  }
+
+  /**
+   * @brief Record that a transfer with the connected camera failed
+   *
+   * The first reconnect attempt is made right away.
+   */
+  void lost()
+  {
+    m_state = state::backing_off;
+    m_deadline = 0;
+    m_backoff = ticks(first_backoff);
+  }
+
+  /**
+   * @brief Number of knocks sent since construction
+   *
+   * @return hal::u32 - reconnect attempts
+   */
+  hal::u32 attempts() const
+  {
+    return m_attempts;
+  }
+
+  /**
+   * @brief Number of successful knocks since construction
+   *
+   * @return hal::u32 - connections made
+   */
+  hal::u32 connects() const
+  {
+    return m_connects;
+  }
+
+private:
+  enum class state : hal::u8
+  {
+    backing_off,
+    knocking,
+    connected,
+    switching,
+  };
+
+  hal::u64 ticks(std::chrono::milliseconds p_duration) const
+  {
+    return static_cast<hal::u64>(m_clock->frequency() *
+                                 static_cast<float>(p_duration.count()) /
+                                 1000.0f);
+  }
+
+  hal::steady_clock* m_clock;
+  hal::u64 m_deadline = 0;
+  hal::u64 m_backoff = 0;
+  hal::u32 m_attempts = 0;
+  hal::u32 m_connects = 0;
+  state m_state = state::backing_off;
+  bool m_change_requested = false;
+};
+}  // namespace e10
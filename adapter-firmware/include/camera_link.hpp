@@ -0,0 +1,244 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <span>
+
+#include <libhal-util/i2c.hpp>
+#include <libhal/i2c.hpp>
+#include <libhal/steady_clock.hpp>
+#include <libhal/units.hpp>
+
+namespace e10 {
+/**
+ * @brief Counters of the camera resynchronisations
+ *
+ */
+struct resync_stats
+{
+  /// Searches for the next response header
+  hal::u32 resyncs = 0;
+  /// Searches that found a header and kept it for the parser
+  hal::u32 recovered = 0;
+  /// Drains of stale data, such as before a knock
+  hal::u32 drains = 0;
+  /// Bytes thrown away by searches and drains
+  hal::u32 bytes_discarded = 0;
+  /// Searches and drains stopped by the time or byte budget
+  hal::u32 budget_exhausted = 0;
+};
+
+/**
+ * @brief Byte stream from the camera with bounded resynchronisation
+ *
+ * Reads go to the camera over I2C, except for bytes a resync already pulled
+ * off the bus, which are handed out first. When a response cannot be parsed,
+ * resync() reads ahead in bulk until it finds the next 0x55 0xAA header and
+ * keeps that header, so parsing resumes from it. drain() throws away stale
+ * data until the camera has nothing left to send. Both stop once
+ * `byte_budget` bytes were discarded or `time_budget` has passed, so a
+ * misbehaving camera can only stall the caller for a bounded time.
+ */
+class camera_link
+{
+public:
+  /// First byte of every camera response
+  static constexpr hal::byte header1 = 0x55;
+  /// Second byte of every camera response
+  static constexpr hal::byte header2 = 0xAA;
+  /// Bytes read from the camera at a time while searching
+  static constexpr std::size_t chunk_size = 16;
+  /// Most bytes a single resync or drain discards
+  static constexpr std::size_t byte_budget = 256;
+  /// Longest time a single resync or drain may take
+  static constexpr auto time_budget = std::chrono::milliseconds(10);
+
+  /// How a resync or drain ended
+  enum class outcome : hal::u8
+  {
+    /// A header was found and will be returned by the next read
+    found_header,
+    /// The camera has nothing left to send
+    idle,
+    /// The time or byte budget ran out first
+    budget_exhausted,
+  };
+
+  /**
+   * @brief Construct a new camera link
+   *
+   * @param p_i2c - camera bus
+   * @param p_clock - clock used to enforce the time budget
+   * @param p_address - camera's I2C address
+   */
+  camera_link(hal::i2c& p_i2c, hal::steady_clock& p_clock, hal::byte p_address)
+    : m_i2c(&p_i2c)
+    , m_clock(&p_clock)
+    , m_address(p_address)
+  {
+    m_budget_ticks = static_cast<hal::u64>(
+      p_clock.frequency() * static_cast<float>(time_budget.count()) / 1000.0f);
+  }
+
+  /**
+   * @brief Send a request to the camera
+   *
+   * Bytes kept from earlier responses are dropped, they cannot belong to the
+   * response of this request.
+   *
+   * @param p_data - request bytes
+   */
+  void write(std::span<hal::byte const> p_data)
+  {
+    m_pending_size = 0;
+    hal::write(*m_i2c, m_address, p_data);
+  }
+
+  /**
+   * @brief Read bytes from the camera
+   *
+   * @param p_data - filled with the next bytes of the stream
+   */
+  void read(std::span<hal::byte> p_data)
+  {
+    auto const kept = std::min(p_data.size(), m_pending_size);
+    std::copy_n(m_pending.begin() + m_pending_start, kept, p_data.begin());
+    m_pending_start += kept;
+    m_pending_size -= kept;
+    if (kept < p_data.size()) {
+      hal::read(*m_i2c, m_address, p_data.subspan(kept));
+    }
+  }
+
+  /**
+   * @brief Skip ahead to the next response header
+   *
+   * @return outcome - found_header if the next read starts on a header
+   */
+  outcome resync()
+  {
+    m_stats.resyncs++;
+    auto const result = scan(true);
+    if (result == outcome::found_header) {
+      m_stats.recovered++;
+    }
+    return result;
+  }
+
+  /**
+   * @brief Throw away everything the camera has buffered
+   *
+   * @return outcome - idle once the camera has nothing left to send
+   */
+  outcome drain()
+  {
+    m_stats.drains++;
+    return scan(false);
+  }
+
+  /**
+   * @brief Counters of the resyncs and drains since construction
+   *
+   * @return resync_stats const& - counters
+   */
+  resync_stats const& stats() const
+  {
+    return m_stats;
+  }
+
+  /**
+   * @brief Camera bus, for requests that bypass the stream
+   *
+   * @return hal::i2c& - bus the camera is on
+   */
+  hal::i2c& bus()
+  {
+    return *m_i2c;
+  }
+
+private:
+  // Discard bytes until a header (if p_keep_header) or an idle camera is found
+  outcome scan(bool p_keep_header)
+  {
+    auto const deadline = m_clock->uptime() + m_budget_ticks;
+    std::size_t discarded = 0;
+    auto const discard = [this, &discarded](std::size_t p_count) {
+      discarded += p_count;
+      m_stats.bytes_discarded += p_count;
+      m_pending_start += p_count;
+      m_pending_size -= p_count;
+    };
+
+    while (true) {
+      if (m_pending_size == 0) {
+        if (discarded >= byte_budget || m_clock->uptime() >= deadline) {
+          m_stats.budget_exhausted++;
+          return outcome::budget_exhausted;
+        }
+        fill(0);
+        // An idle camera answers every read with 0xFF
+        if (std::ranges::all_of(m_pending,
+                                [](hal::byte p_byte) { return p_byte == 0xFF; })) {
+          discard(m_pending_size);
+          return outcome::idle;
+        }
+      }
+
+      if (not p_keep_header) {
+        discard(m_pending_size);
+        continue;
+      }
+
+      auto const begin = m_pending.begin() + m_pending_start;
+      auto const found = std::find(begin, begin + m_pending_size, header1);
+      discard(static_cast<std::size_t>(found - begin));
+      if (m_pending_size == 0) {
+        continue;
+      }
+      if (m_pending_size == 1) {
+        // The header may continue in the next chunk, keep its first byte
+        fill(1);
+      }
+      if (m_pending[m_pending_start + 1] == header2) {
+        return outcome::found_header;
+      }
+      discard(1);
+    }
+  }
+
+  // Move p_keep pending bytes to the front and fill the rest from the camera
+  void fill(std::size_t p_keep)
+  {
+    std::copy_n(
+      m_pending.begin() + m_pending_start, p_keep, m_pending.begin());
+    hal::read(*m_i2c, m_address, std::span(m_pending).subspan(p_keep));
+    m_pending_start = 0;
+    m_pending_size = m_pending.size();
+  }
+
+  hal::i2c* m_i2c;
+  hal::steady_clock* m_clock;
+  hal::byte m_address;
+  hal::u64 m_budget_ticks = 0;
+  std::array<hal::byte, chunk_size> m_pending{};
+  std::size_t m_pending_start = 0;
+  std::size_t m_pending_size = 0;
+  resync_stats m_stats{};
+};
+}  // namespace e10
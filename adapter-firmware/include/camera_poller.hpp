@@ -0,0 +1,224 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+
+#include <libhal/steady_clock.hpp>
+#include <libhal/units.hpp>
+
+#include "e10_protocol.hpp"
+
+namespace e10 {
+/**
+ * @brief Latest camera result and when it was read
+ *
+ */
+struct camera_frame
+{
+  /// First block followed by its checksum, all zeros if the camera had none
+  std::array<hal::byte, 9> block{};
+  /// Objects reported by the camera, in the order it reported them
+  std::array<protocol::camera_object, protocol::max_camera_objects> objects{};
+  /// Number of valid entries in `objects`
+  hal::u8 object_count = 0;
+  /// Clock uptime at which the block was read
+  hal::u64 captured = 0;
+  /// A block has been read since the poller was constructed
+  bool valid = false;
+};
+
+/**
+ * @brief Schedules camera reads from the main loop and caches the result
+ *
+ * The main loop reads the camera whenever due() says so and hands the result to
+ * store(). Commands answer from latest() instead of waiting on the I2C bus.
+ * Reads are spaced by the camera's frame period so the bus is not polled
+ * faster than the camera produces results.
+ *
+ * Results are kept per camera algorithm. After select() switches algorithms,
+ * latest() answers from the new algorithm's slot, which is empty until a read
+ * made with that algorithm is stored. A result of the previous algorithm is
+ * therefore never returned for the new one. The least recently selected slot
+ * is reused once every slot holds an algorithm.
+ */
+class camera_poller
+{
+public:
+  /// Time between reads, the HuskyLens produces about 30 results per second
+  static constexpr auto frame_period = std::chrono::milliseconds(33);
+  /// Number of algorithms whose latest result is kept
+  static constexpr std::size_t algorithm_slots = 4;
+
+  /**
+   * @brief Construct a new camera poller with an empty cache
+   *
+   * @param p_clock - clock used to schedule reads and time stamp blocks
+   */
+  camera_poller(hal::steady_clock& p_clock)
+    : m_clock(&p_clock)
+  {
+    m_frame_ticks = ticks(frame_period);
+  }
+
+  /**
+   * @brief Switch the algorithm whose results are stored and returned
+   *
+   * Schedules a read right away so the new algorithm's slot fills quickly.
+   *
+   * @param p_algorithm - camera algorithm ID
+   */
+  void select(hal::byte p_algorithm)
+  {
+    // Use the algorithm's slot, otherwise an unused or the least recently
+    // selected one. Unused slots were never selected.
+    std::size_t chosen = 0;
+    for (std::size_t i = 0; i < m_slots.size(); i++) {
+      if (m_slots[i].used && m_slots[i].algorithm == p_algorithm) {
+        chosen = i;
+        break;
+      }
+      if (m_slots[i].last_selected < m_slots[chosen].last_selected) {
+        chosen = i;
+      }
+    }
+
+    auto& entry = m_slots[chosen];
+    if (not entry.used || entry.algorithm != p_algorithm) {
+      entry = { .algorithm = p_algorithm, .used = true };
+    }
+    entry.last_selected = ++m_selections;
+    m_active = chosen;
+    m_next_read = 0;
+  }
+
+  /**
+   * @brief Algorithm whose results are stored and returned
+   *
+   * @return hal::byte - camera algorithm ID
+   */
+  hal::byte algorithm() const
+  {
+    return m_slots[m_active].algorithm;
+  }
+
+  /**
+   * @brief Determine if the camera should be read
+   *
+   * @return true - the period since the last read has passed
+   */
+  bool due() const
+  {
+    return m_clock->uptime() >= m_next_read;
+  }
+
+  /**
+   * @brief Cache the result of a camera read and schedule the next one
+   *
+   * @param p_frame - result read from the camera, its time stamp is set here
+   */
+  void store(camera_frame const& p_frame)
+  {
+    auto const now = m_clock->uptime();
+    auto& frame = m_slots[m_active].frame;
+    frame = p_frame;
+    frame.captured = now;
+    frame.valid = true;
+    m_next_read = now + m_frame_ticks;
+    m_reads++;
+  }
+
+  /**
+   * @brief Forget the cached results of every algorithm
+   *
+   * latest() answers with an empty, invalid result and age_ms() with 0xFFFF
+   * until the next store(). The next read is due right away.
+   */
+  void invalidate()
+  {
+    for (auto& slot : m_slots) {
+      slot.frame = {};
+    }
+    m_next_read = 0;
+  }
+
+  /**
+   * @brief Latest cached result of the selected algorithm
+   *
+   * @return camera_frame const& - cached result and its time stamp
+   */
+  camera_frame const& latest() const
+  {
+    return m_slots[m_active].frame;
+  }
+
+  /**
+   * @brief Age of the cached block
+   *
+   * @return hal::u16 - milliseconds since the block was read, saturated at
+   * 0xFFFF which is also returned when nothing has been read yet.
+   */
+  hal::u16 age_ms() const
+  {
+    constexpr auto saturated = std::numeric_limits<hal::u16>::max();
+    auto const& frame = latest();
+    if (not frame.valid) {
+      return saturated;
+    }
+    auto const elapsed = m_clock->uptime() - frame.captured;
+    auto const ms =
+      static_cast<float>(elapsed) * 1000.0f / m_clock->frequency();
+    return ms >= saturated ? saturated : static_cast<hal::u16>(ms);
+  }
+
+  /**
+   * @brief Number of camera reads stored since construction
+   *
+   * @return hal::u32 - stored reads
+   */
+  hal::u32 reads() const
+  {
+    return m_reads;
+  }
+
+private:
+  struct slot
+  {
+    camera_frame frame{};
+    hal::u32 last_selected = 0;
+    hal::byte algorithm = 0;
+    bool used = false;
+  };
+
+  hal::u64 ticks(std::chrono::milliseconds p_duration) const
+  {
+    return static_cast<hal::u64>(m_clock->frequency() *
+                                 static_cast<float>(p_duration.count()) /
+                                 1000.0f);
+  }
+
+  hal::steady_clock* m_clock;
+  std::array<slot, algorithm_slots> m_slots{ slot{ .last_selected = 1,
+                                                   .used = true } };
+  std::size_t m_active = 0;
+  hal::u32 m_selections = 1;
+  hal::u64 m_frame_ticks = 0;
+  hal::u64 m_next_read = 0;
+  hal::u32 m_reads = 0;
+};
+}  // namespace e10
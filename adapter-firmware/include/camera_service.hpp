@@ -0,0 +1,99 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <optional>
+#include <span>
+
+#include <libhal/serial.hpp>
+#include <libhal/units.hpp>
+
+#include "camera_connection.hpp"
+#include "camera_link.hpp"
+#include "camera_poller.hpp"
+
+namespace e10 {
+/**
+ * @brief Keeps the camera connected and its cache filled from the main loop
+ *
+ * Ties the camera protocol to the connection's reconnect and algorithm change
+ * steps and to the poller's cache. step() does at most one camera exchange,
+ * so the main loop never waits on the camera for longer than that exchange.
+ * A failed exchange marks the camera as lost and empties the cache, nothing
+ * is stored for it.
+ */
+class camera_service
+{
+public:
+  struct resources_t
+  {
+    camera_link& link;
+    camera_poller& poller;
+    camera_connection& connection;
+    hal::serial& console;
+    /// Buffer for the camera responses
+    std::span<hal::byte> buffer;
+  };
+
+  /**
+   * @brief Construct a new camera service
+   *
+   * @param p_resources - camera link, cache, connection and console
+   */
+  camera_service(resources_t p_resources);
+
+  /**
+   * @brief Take the camera step that is due, if any
+   *
+   * Advances a reconnect or algorithm change first, otherwise reads the camera
+   * into the cache once the poller says a read is due.
+   *
+   * @return true - the camera was talked to
+   */
+  bool step();
+
+  /**
+   * @brief Read the camera's latest result with the selected algorithm
+   *
+   * @return std::optional<camera_frame> - objects read from the camera,
+   * std::nullopt if the camera could not be read, which also marks it as lost.
+   */
+  std::optional<camera_frame> read();
+
+  /**
+   * @brief Read the camera and cache the result if the read succeeded
+   *
+   */
+  void poll();
+
+  /**
+   * @brief Take the due step of reconnecting to the camera or of switching its
+   * algorithm
+   *
+   */
+  void advance();
+
+  /**
+   * @brief Mark the camera as lost and empty the cached results
+   *
+   */
+  void lost();
+
+private:
+  resources_t m_resources;
+  /// Algorithm of the last change sent to the camera
+  hal::byte m_algorithm_sent = 0;
+};
+}  // namespace e10
@@ -0,0 +1,192 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace e10 {
+/**
+ * @brief Log-bucketed histogram of command latencies
+ *
+ * Bucket `b` counts latencies of `2^b` up to `2^(b+1) - 1` microseconds,
+ * bucket 0 also counts latencies below 1 us and the last bucket everything
+ * from `2^(bucket_count - 1)` us up. Memory use is fixed and recording is a
+ * handful of instructions.
+ *
+ * Only depends on the standard library so it can be built on the host.
+ */
+class latency_histogram
+{
+public:
+  /// Number of buckets, the last one starts at 32.768 ms
+  static constexpr std::size_t bucket_count = 16;
+
+  /**
+   * @brief Bucket a latency is counted in
+   *
+   * @param p_microseconds - latency
+   * @return std::size_t - bucket index
+   */
+  static constexpr std::size_t bucket(std::uint32_t p_microseconds)
+  {
+    auto const index =
+      static_cast<std::size_t>(std::bit_width(p_microseconds | 1U) - 1);
+    return std::min(index, bucket_count - 1);
+  }
+
+  /**
+   * @brief Count a latency
+   *
+   * Counts saturate instead of wrapping around.
+   *
+   * @param p_microseconds - latency
+   */
+  void record(std::uint32_t p_microseconds)
+  {
+    auto& count = m_buckets[bucket(p_microseconds)];
+    if (count != UINT32_MAX) {
+      count++;
+    }
+    if (m_count != UINT32_MAX) {
+      m_count++;
+    }
+    m_max = std::max(m_max, p_microseconds);
+  }
+
+  /**
+   * @brief Counts of every bucket
+   *
+   * @return std::array<std::uint32_t, bucket_count> const& - counts
+   */
+  std::array<std::uint32_t, bucket_count> const& buckets() const
+  {
+    return m_buckets;
+  }
+
+  /**
+   * @brief Number of latencies recorded
+   *
+   * @return std::uint32_t - recorded latencies, saturated at UINT32_MAX
+   */
+  std::uint32_t count() const
+  {
+    return m_count;
+  }
+
+  /**
+   * @brief Longest latency recorded
+   *
+   * @return std::uint32_t - microseconds, 0 if nothing was recorded
+   */
+  std::uint32_t max() const
+  {
+    return m_max;
+  }
+
+private:
+  std::array<std::uint32_t, bucket_count> m_buckets{};
+  std::uint32_t m_count = 0;
+  std::uint32_t m_max = 0;
+};
+
+/**
+ * @brief Latency histograms of the commands the adapter handled
+ *
+ * A histogram is assigned to each command the first time it is recorded.
+ * Once every slot is taken, further commands share the last slot, which is
+ * reported with command byte overflow_command.
+ */
+class command_metrics
+{
+public:
+  /// Number of histograms, one is reserved for the commands that do not fit
+  static constexpr std::size_t command_slots = 16;
+  /// Command byte that stands for the shared overflow histogram
+  static constexpr std::uint8_t overflow_command = 0xFF;
+
+  /**
+   * @brief Count the latency of a handled command
+   *
+   * @param p_command - command byte, must not be overflow_command
+   * @param p_microseconds - time from taking the command off the queue to
+   * sending its response
+   */
+  void record(std::uint8_t p_command, std::uint32_t p_microseconds)
+  {
+    std::size_t index = 0;
+    while (index < m_used && m_commands[index] != p_command) {
+      index++;
+    }
+    if (index == m_used) {
+      if (m_used < command_slots - 1) {
+        m_commands[m_used++] = p_command;
+      } else {
+        index = command_slots - 1;
+        m_overflow_used = true;
+      }
+    }
+    m_histograms[index].record(p_microseconds);
+  }
+
+  /**
+   * @brief Histogram of a command
+   *
+   * @param p_command - command byte, overflow_command for the shared overflow
+   * histogram
+   * @return latency_histogram const* - nullptr if the command was never
+   * recorded
+   */
+  latency_histogram const* find(std::uint8_t p_command) const
+  {
+    if (p_command == overflow_command) {
+      return m_overflow_used ? &m_histograms.back() : nullptr;
+    }
+    for (std::size_t i = 0; i < m_used; i++) {
+      if (m_commands[i] == p_command) {
+        return &m_histograms[i];
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief Commands that have a histogram, in the order first recorded
+   *
+   * @param p_commands - filled with the command bytes, overflow_command
+   * stands for the overflow histogram
+   * @return std::size_t - number of entries written
+   */
+  std::size_t commands(
+    std::array<std::uint8_t, command_slots>& p_commands) const
+  {
+    std::copy_n(m_commands.begin(), m_used, p_commands.begin());
+    if (not m_overflow_used) {
+      return m_used;
+    }
+    p_commands[m_used] = overflow_command;
+    return m_used + 1;
+  }
+
+private:
+  std::array<latency_histogram, command_slots> m_histograms{};
+  std::array<std::uint8_t, command_slots> m_commands{};
+  std::size_t m_used = 0;
+  bool m_overflow_used = false;
+};
+}  // namespace e10
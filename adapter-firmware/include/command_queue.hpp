@@ -0,0 +1,310 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+#include <libhal/serial.hpp>
+#include <libhal/steady_clock.hpp>
+#include <libhal/units.hpp>
+
+#include "e10_protocol.hpp"
+
+namespace e10 {
+/**
+ * @brief A complete request waiting to be handled
+ *
+ */
+struct received_command
+{
+  /// Request as received. Unframed requests have a sequence number of 0 and
+  /// their payload without its checksum.
+  protocol::frame request{};
+  /// The request arrived in a frame and must be answered with one
+  bool framed = false;
+  /// The request arrived on the console instead of the RS485 link
+  bool console = false;
+};
+
+/**
+ * @brief Fixed size queue of received commands
+ *
+ * Lock free for a single producer and a single consumer, so commands may be
+ * queued from an interrupt and handled by the main loop.
+ *
+ * @tparam Capacity - most commands that can wait at once
+ */
+template<std::size_t Capacity>
+class command_queue
+{
+public:
+  /**
+   * @brief Add a command to the back of the queue
+   *
+   * @param p_command - command to add
+   * @return true - the command was queued, false if the queue was full
+   */
+  bool push(received_command const& p_command)
+  {
+    auto const head = m_head.load(std::memory_order_relaxed);
+    auto const tail = m_tail.load(std::memory_order_acquire);
+    if (head - tail == Capacity) {
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    m_commands[head % Capacity] = p_command;
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Take the command at the front of the queue
+   *
+   * @param p_command - filled with the command if there is one
+   * @return true - p_command holds the oldest command
+   */
+  bool pop(received_command& p_command)
+  {
+    auto const tail = m_tail.load(std::memory_order_relaxed);
+    auto const head = m_head.load(std::memory_order_acquire);
+    if (head == tail) {
+      return false;
+    }
+    p_command = m_commands[tail % Capacity];
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Determine if no commands are waiting
+   *
+   * @return true - the queue is empty
+   */
+  bool empty() const
+  {
+    return m_head.load(std::memory_order_acquire) ==
+           m_tail.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Number of commands dropped because the queue was full
+   *
+   * @return std::size_t - dropped commands since construction
+   */
+  std::size_t dropped() const
+  {
+    return m_dropped.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::array<received_command, Capacity> m_commands{};
+  std::atomic<std::size_t> m_head = 0;
+  std::atomic<std::size_t> m_tail = 0;
+  std::atomic<std::size_t> m_dropped = 0;
+};
+
+/**
+ * @brief Splits the bytes received on one serial port into commands
+ *
+ * Framed requests are decoded with a protocol::frame_parser. Unframed
+ * requests are a command byte followed, for commands that have one, by the
+ * payload and its checksum. Bytes are accepted as they arrive, so nothing
+ * ever blocks waiting for the rest of a request. An unframed payload that
+ * does not finish within the reader's timeout is abandoned, as is a partial
+ * frame that receives no byte for that long. The latter stops a stray sync
+ * byte from swallowing the unframed commands that follow it.
+ */
+class command_reader
+{
+public:
+  /// Longest time an unframed payload may take to arrive on the RS485 link,
+  /// and longest gap between the bytes of a frame
+  static constexpr hal::time_duration payload_timeout =
+    std::chrono::milliseconds(10);
+  /// Same for the console, where commands and payloads are typed by hand
+  static constexpr hal::time_duration console_payload_timeout =
+    std::chrono::seconds(5);
+
+  /**
+   * @brief Construct a new command reader
+   *
+   * @param p_clock - clock used to time out payloads and partial frames
+   * @param p_console - commands are read from the console, which waits
+   * `console_payload_timeout` rather than `payload_timeout` for the rest of a
+   * request
+   */
+  command_reader(hal::steady_clock& p_clock, bool p_console)
+    : m_clock(&p_clock)
+    , m_console(p_console)
+  {
+    auto const timeout = p_console ? console_payload_timeout : payload_timeout;
+    auto const ticks_per_ns = p_clock.frequency() / 1e9f;
+    m_timeout = static_cast<hal::u64>(
+      static_cast<float>(std::chrono::nanoseconds(timeout).count()) *
+      ticks_per_ns);
+  }
+
+  /**
+   * @brief Queue every complete command waiting on a serial port
+   *
+   * @param p_serial - port to read from
+   * @param p_queue - queue to add the commands to
+   */
+  template<std::size_t Capacity>
+  void poll(hal::serial& p_serial, command_queue<Capacity>& p_queue)
+  {
+    auto const now = m_clock->uptime();
+    if (m_remaining != 0 && now > m_deadline) {
+      m_rejected++;
+      m_remaining = 0;
+    }
+    if (m_frames.in_frame() && now > m_frame_deadline) {
+      m_frames.reset();
+    }
+
+    std::array<hal::byte, 32> received{};
+    bool first_read = true;
+    while (true) {
+      auto const result = p_serial.read(received);
+      // A receive buffer found full may have dropped bytes since the last poll
+      if (first_read && result.capacity != 0 &&
+          result.data.size() + result.available >= result.capacity) {
+        m_overruns++;
+      }
+      first_read = false;
+      for (auto const byte : result.data) {
+        push(byte, now, p_queue);
+      }
+      if (result.data.size() < received.size()) {
+        return;
+      }
+    }
+  }
+
+  /**
+   * @brief Determine if part of a request has been received
+   *
+   * @return true - an unframed payload or a frame is still arriving
+   */
+  bool receiving() const
+  {
+    return m_remaining != 0 || m_frames.in_frame();
+  }
+
+  /**
+   * @brief Number of unframed commands rejected for a bad or late payload
+   *
+   * @return hal::u32 - rejected commands since construction
+   */
+  hal::u32 rejected() const
+  {
+    return m_rejected;
+  }
+
+  /**
+   * @brief Number of unframed payloads whose checksum did not match
+   *
+   * Framed requests with a bad CRC are counted by frames().
+   *
+   * @return hal::u32 - checksum mismatches since construction
+   */
+  hal::u32 checksum_errors() const
+  {
+    return m_checksum_errors;
+  }
+
+  /**
+   * @brief Number of polls that found the receive buffer full
+   *
+   * Bytes that arrived while the buffer was full were lost.
+   *
+   * @return hal::u32 - overruns since construction
+   */
+  hal::u32 overruns() const
+  {
+    return m_overruns;
+  }
+
+  /**
+   * @brief Frame decoder of this port
+   *
+   * @return protocol::frame_parser const& - parser holding the frame statistics
+   */
+  protocol::frame_parser const& frames() const
+  {
+    return m_frames;
+  }
+
+private:
+  template<std::size_t Capacity>
+  void push(hal::byte p_byte, hal::u64 p_now, command_queue<Capacity>& p_queue)
+  {
+    if (m_remaining != 0) {
+      m_remaining--;
+      if (m_remaining != 0) {
+        auto& request = m_pending.request;
+        request.payload[request.length++] = p_byte;
+        m_checksum += p_byte;
+      } else if (p_byte == m_checksum) {
+        p_queue.push(m_pending);
+      } else {
+        m_rejected++;
+        m_checksum_errors++;
+      }
+      return;
+    }
+
+    if (m_frames.in_frame() || p_byte == protocol::frame_sync) {
+      m_frames.push(p_byte);
+      m_frame_deadline = p_now + m_timeout;
+      m_pending.framed = true;
+      m_pending.console = m_console;
+      while (m_frames.next(m_pending.request)) {
+        p_queue.push(m_pending);
+      }
+      return;
+    }
+
+    m_pending = { .request = { .command = p_byte }, .console = m_console };
+    auto const size =
+      protocol::payload_size(static_cast<protocol::command>(p_byte));
+    if (size == 0) {
+      p_queue.push(m_pending);
+      return;
+    }
+
+    // Collect the payload and the checksum that follows it
+    m_remaining = size + 1;
+    m_checksum = 0;
+    m_deadline = p_now + m_timeout;
+  }
+
+  hal::steady_clock* m_clock;
+  protocol::frame_parser m_frames{};
+  received_command m_pending{};
+  hal::u64 m_timeout = 0;
+  hal::u64 m_deadline = 0;
+  hal::u64 m_frame_deadline = 0;
+  hal::u32 m_rejected = 0;
+  hal::u32 m_checksum_errors = 0;
+  hal::u32 m_overruns = 0;
+  std::size_t m_remaining = 0;
+  hal::byte m_checksum = 0;
+  bool m_console;
+};
+}  // namespace e10
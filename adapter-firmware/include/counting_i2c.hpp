@@ -0,0 +1,103 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <span>
+
+#include <libhal/i2c.hpp>
+#include <libhal/units.hpp>
+
+namespace e10 {
+/**
+ * @brief I2C bus that counts the traffic passing through it
+ *
+ * Every transaction is passed straight to the wrapped bus. Used to measure
+ * how much bus traffic a camera exchange costs.
+ */
+class counting_i2c : public hal::i2c
+{
+public:
+  /**
+   * @brief Construct a new counting i2c
+   *
+   * @param p_i2c - bus the transactions are passed on to
+   */
+  counting_i2c(hal::i2c& p_i2c)
+    : m_i2c(&p_i2c)
+  {
+  }
+
+  /**
+   * @brief Number of transactions started since construction
+   *
+   * @return hal::u32 - transaction count, including failed ones
+   */
+  hal::u32 transactions() const
+  {
+    return m_transactions;
+  }
+
+  /**
+   * @brief Number of data bytes written and read since construction
+   *
+   * Address bytes are not included.
+   *
+   * @return hal::u32 - bytes moved over the bus
+   */
+  hal::u32 bytes() const
+  {
+    return m_bytes;
+  }
+
+  /**
+   * @brief Number of transactions that failed since construction
+   *
+   * Mostly transactions the device did not acknowledge.
+   *
+   * @return hal::u32 - failed transactions
+   */
+  hal::u32 failures() const
+  {
+    return m_failures;
+  }
+
+private:
+  void driver_configure(settings const& p_settings) override
+  {
+    m_i2c->configure(p_settings);
+  }
+
+  void driver_transaction(
+    hal::byte p_address,
+    std::span<hal::byte const> p_data_out,
+    std::span<hal::byte> p_data_in,
+    hal::function_ref<hal::timeout_function> p_timeout) override
+  {
+    m_transactions++;
+    m_bytes += p_data_out.size() + p_data_in.size();
+    try {
+      m_i2c->transaction(p_address, p_data_out, p_data_in, p_timeout);
+    } catch (...) {
+      m_failures++;
+      throw;
+    }
+  }
+
+  hal::i2c* m_i2c;
+  hal::u32 m_transactions = 0;
+  hal::u32 m_bytes = 0;
+  hal::u32 m_failures = 0;
+};
+}  // namespace e10
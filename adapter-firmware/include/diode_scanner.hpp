@@ -0,0 +1,324 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+
+#include <libhal/adc.hpp>
+#include <libhal/output_pin.hpp>
+#include <libhal/steady_clock.hpp>
+#include <libhal/timer.hpp>
+#include <libhal/units.hpp>
+
+#include "double_buffer.hpp"
+#include "reference_tracker.hpp"
+#include "sample_filter.hpp"
+
+namespace e10 {
+enum class irb_freq : hal::u8
+{
+  low = 0,
+  high = 1,
+};
+
+constexpr std::size_t diode_count = 8;
+
+/**
+ * @brief Result of one complete pass over all of the photo diodes
+ *
+ */
+struct diode_sweep
+{
+  /// Intensity of each photo diode mapped to 0 to 255 relative to `reference`
+  std::array<hal::u8, diode_count> samples{};
+  /// Filtered intensity of each photo diode mapped to 0 to 65535 relative to
+  /// `reference`. `samples` holds the upper 8 bits of these values.
+  std::array<hal::u16, diode_count> intensity{};
+  /// Smoothed reference voltage divider reading used to map the samples
+  float reference = 0.0f;
+  /// Frequency channel the sweep was taken on
+  irb_freq frequency = irb_freq::low;
+  /// Steady clock uptime when the sweep finished
+  hal::u64 completed_at = 0;
+};
+
+/**
+ * @brief Timing of the photo diode multiplexer sequence
+ *
+ */
+struct diode_timing
+{
+  /// Time counter reset is held high before the first diode is selected
+  hal::time_duration reset_hold = std::chrono::microseconds(10);
+  /// Time counter clock is held high while the diode accumulates charge
+  hal::time_duration integration = std::chrono::milliseconds(3);
+  /// Time after the counter clock falls before the intensity is sampled
+  hal::time_duration settle = std::chrono::milliseconds(5);
+  /// Time after frequency select changes before the intensity is sampled,
+  /// only used by interleaved sweeps.
+  hal::time_duration frequency_settle = std::chrono::microseconds(500);
+};
+
+/**
+ * @brief Order in which the two frequency channels are sampled
+ *
+ */
+enum class sweep_mode : hal::u8
+{
+  /// A full sweep of the low channel followed by a full sweep of the high
+  /// channel, each paying for the reset, integration and settle times.
+  sequential = 0,
+  /// Both channels are sampled at every diode before the counter advances, so
+  /// one pass of the multiplexer produces the results for both channels.
+  interleaved = 1,
+};
+
+/**
+ * @brief Modeled duration of one sweep over every photo diode
+ *
+ * @param p_timing - multiplexer timing
+ * @return constexpr hal::time_duration - time from reset to the last sample
+ */
+constexpr hal::time_duration sweep_duration(diode_timing const& p_timing)
+{
+  return p_timing.reset_hold +
+         diode_count * (p_timing.integration + p_timing.settle);
+}
+
+/**
+ * @brief Modeled time to produce a result for both frequency channels
+ *
+ * @param p_timing - multiplexer timing
+ * @param p_mode - channel ordering
+ * @return constexpr hal::time_duration - time to refresh both channels
+ */
+constexpr hal::time_duration dual_sweep_duration(diode_timing const& p_timing,
+                                                 sweep_mode p_mode)
+{
+  if (p_mode == sweep_mode::interleaved) {
+    return sweep_duration(p_timing) +
+           diode_count * p_timing.frequency_settle;
+  }
+  return 2 * sweep_duration(p_timing);
+}
+
+/// Shortest integration or settle time that may be configured
+constexpr hal::time_duration min_phase_time = std::chrono::microseconds(100);
+/// Longest integration or settle time that may be configured
+constexpr hal::time_duration max_phase_time = std::chrono::milliseconds(20);
+
+// The timer driven sequence must keep the edges and settle times of the
+// original blocking hal::delay() based sampler.
+static_assert(sweep_duration(diode_timing{}) ==
+              std::chrono::microseconds(10) +
+                8 * (std::chrono::milliseconds(3) +
+                     std::chrono::milliseconds(5)));
+
+/**
+ * @brief Continuously sweeps the IRB photo diodes in the background
+ *
+ * In sequential mode the scanner alternates between a low frequency and a high
+ * frequency sweep of the photo diode multiplexer. In interleaved mode a single
+ * sweep samples both frequencies at every diode. Each completed sweep is
+ * published into a double buffer per frequency so that a command can be
+ * answered immediately from the latest finished sweep.
+ *
+ * The multiplexer sequence is a state machine where each step performs a pin
+ * or ADC action and returns how long to wait before the next step. Steps are
+ * run from the timer's interrupt, leaving the main loop free. The scanner must
+ * be the only user of the intensity and reference ADCs once started, as they
+ * are read from interrupt context.
+ */
+class diode_scanner
+{
+public:
+  struct resources_t
+  {
+    hal::output_pin& counter_reset;
+    hal::output_pin& counter_clock;
+    hal::output_pin& frequency_select;
+    hal::adc& intensity;
+    hal::adc& reference;
+    hal::steady_clock& clock;
+    hal::timer& timer;
+  };
+
+  /**
+   * @brief Construct a new diode scanner
+   *
+   * @param p_resources - pins, adcs and clock used to drive the IRB hardware
+   */
+  diode_scanner(resources_t p_resources);
+
+  /**
+   * @brief Begin sweeping in the background
+   *
+   * Schedules the first step of the sequence on the timer. Every following
+   * step reschedules itself from the timer interrupt.
+   */
+  void start();
+
+  /**
+   * @brief Copy of the latest completed sweep for a frequency
+   *
+   * @param p_frequency - frequency channel of interest
+   * @return diode_sweep - latest sweep, all zeros if none have finished
+   */
+  diode_sweep latest(irb_freq p_frequency) const;
+
+  /**
+   * @brief Number of sweeps completed since construction
+   *
+   * @param p_frequency - frequency channel of interest
+   * @return hal::u32 - number of sweeps published for that frequency
+   */
+  hal::u32 sweeps_completed(irb_freq p_frequency) const;
+
+  /**
+   * @brief Override the integration and settle times
+   *
+   * Takes effect at the start of the next sweep.
+   *
+   * @param p_timing - new multiplexer timing
+   * @throws hal::argument_out_of_domain - if the integration or settle time is
+   * outside of [min_phase_time, max_phase_time].
+   */
+  void set_timing(diode_timing const& p_timing);
+
+  /**
+   * @brief Timing currently used by the multiplexer sequence
+   *
+   * @return diode_timing - active timing
+   */
+  diode_timing timing() const;
+
+  /**
+   * @brief Measure and apply the shortest safe integration and settle times
+   *
+   * Starting at the next sweep, one sweep per frequency is run at the default
+   * timing while the intensity ADC is sampled every
+   * `calibration_interval` after each counter clock edge. The time for the
+   * reading to converge to within `calibration_tolerance` of its final value
+   * is measured for every diode. The worst case, scaled by
+   * `calibration_margin`, becomes the new integration and settle time.
+   */
+  void calibrate();
+
+  /**
+   * @brief Determine if a calibration is requested or in progress
+   *
+   * @return true - calibration has not finished yet
+   */
+  bool calibrating() const;
+
+  /**
+   * @brief Select how the two frequency channels are sampled
+   *
+   * Takes effect at the start of the next sweep.
+   *
+   * @param p_mode - channel ordering
+   */
+  void set_mode(sweep_mode p_mode);
+
+  /**
+   * @brief Channel ordering selected for the sweeps
+   *
+   * @return sweep_mode - selected channel ordering
+   */
+  sweep_mode mode() const;
+
+  /**
+   * @brief Set how many readings are taken and filtered for each diode
+   *
+   * Takes effect at the start of the next sweep.
+   *
+   * @param p_oversampling - burst length and reduction filter
+   * @throws hal::argument_out_of_domain - if the count is 0 or above
+   * oversampling::max_count.
+   */
+  void set_oversampling(oversampling p_oversampling);
+
+  /**
+   * @brief Oversampling selected for the sweeps
+   *
+   * @return oversampling - burst length and reduction filter
+   */
+  oversampling current_oversampling() const;
+
+  /**
+   * @brief Smoothed reference used to map the intensity readings
+   *
+   * @return float - reference ratio
+   */
+  float reference() const;
+
+  /// Period between ADC readings while calibrating
+  static constexpr hal::time_duration calibration_interval =
+    std::chrono::microseconds(100);
+  /// Band, as a fraction of the reference, a reading must stay within
+  static constexpr float calibration_tolerance = 0.01f;
+  /// Multiplier applied to the measured convergence time
+  static constexpr float calibration_margin = 1.5f;
+
+private:
+  enum class state : hal::u8
+  {
+    begin_sweep,
+    release_reset,
+    clock_high,
+    integrating,
+    clock_low,
+    settling,
+    sample,
+    sample_high,
+  };
+
+  void on_timer();
+  hal::time_duration step();
+  hal::time_duration trace_intensity(hal::time_duration p_window,
+                                     hal::time_duration& p_worst_case);
+  void finish_calibration();
+  void store_sample(irb_freq p_frequency);
+  hal::time_duration next_diode();
+
+  resources_t m_resources;
+  reference_tracker m_reference_tracker;
+  std::array<double_buffer<diode_sweep>, 2> m_results{};
+  std::array<diode_sweep, 2> m_working{};
+  diode_timing m_timing{};
+  double_buffer<diode_timing> m_requested_timing{};
+  double_buffer<diode_timing> m_active_timing{};
+  hal::u32 m_applied_generation = 0;
+  std::array<float, 64> m_trace{};
+  hal::time_duration m_trace_elapsed{};
+  hal::time_duration m_worst_integration{};
+  hal::time_duration m_worst_settle{};
+  std::atomic<bool> m_calibrate_requested = false;
+  std::atomic<bool> m_calibrating = false;
+  std::atomic<sweep_mode> m_requested_mode = sweep_mode::sequential;
+  std::atomic<oversampling> m_requested_oversampling{};
+  oversampling m_oversampling{};
+  std::array<float, oversampling::max_count> m_burst{};
+  float m_reference = 0.0f;
+  hal::u8 m_trace_length = 0;
+  hal::u8 m_calibration_sweeps = 0;
+  state m_state = state::begin_sweep;
+  hal::u8 m_diode = 0;
+  irb_freq m_frequency = irb_freq::low;
+  sweep_mode m_mode = sweep_mode::sequential;
+};
+}  // namespace e10
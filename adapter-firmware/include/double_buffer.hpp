@@ -0,0 +1,96 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include <libhal/units.hpp>
+
+namespace e10 {
+/**
+ * @brief Single producer, single consumer double buffer
+ *
+ * The producer fills the back slot via `back()` and makes it visible with
+ * `publish()`. The consumer copies the front slot out via `read()`. Each
+ * publish swaps the front slot and then bumps a generation counter, which
+ * `read()` uses to detect a publish that raced with its copy, in which case
+ * the copy is retried. A reader that sees the new generation is guaranteed to
+ * also see the new front slot, so it can never copy the slot the producer is
+ * writing to next. This makes the buffer safe to use with a producer running
+ * in interrupt context or on another thread and a consumer running in the
+ * main loop.
+ *
+ * @tparam T - trivially copyable type to publish
+ */
+template<typename T>
+class double_buffer
+{
+public:
+  /**
+   * @brief Slot that the producer is allowed to write to
+   *
+   * @return T& - back slot, never observed by `read()` until published
+   */
+  T& back()
+  {
+    return m_slots[m_front.load(std::memory_order_relaxed) ^ 1U];
+  }
+
+  /**
+   * @brief Swap the back slot to the front making it visible to readers
+   *
+   */
+  void publish()
+  {
+    auto const front = m_front.load(std::memory_order_relaxed);
+    m_front.store(front ^ 1U, std::memory_order_release);
+    // Acquire keeps the producer's next writes to back() after the bump
+    m_generation.fetch_add(1, std::memory_order_acq_rel);
+  }
+
+  /**
+   * @brief Copy out the most recently published value
+   *
+   * @return T - copy of the front slot
+   */
+  T read() const
+  {
+    while (true) {
+      auto const generation = m_generation.load(std::memory_order_acquire);
+      T const copy = m_slots[m_front.load(std::memory_order_acquire)];
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (generation == m_generation.load(std::memory_order_relaxed)) {
+        return copy;
+      }
+    }
+  }
+
+  /**
+   * @brief Number of times `publish()` has been called
+   *
+   * @return hal::u32 - publish count
+   */
+  hal::u32 generation() const
+  {
+    return m_generation.load(std::memory_order_acquire);
+  }
+
+private:
+  std::array<T, 2> m_slots{};
+  std::atomic<hal::u32> m_front = 0;
+  std::atomic<hal::u32> m_generation = 0;
+};
+}  // namespace e10
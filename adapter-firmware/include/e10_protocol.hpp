@@ -0,0 +1,569 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+// This header is shared between the adapter firmware and the VEX brain's
+// `e10::adapter`. It must only depend on the standard library and stay C++11
+// compatible for VEXcode. The VEX code in vex-code/ carries a copy of it, keep
+// the two in sync.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace e10 {
+namespace protocol {
+/**
+ * @brief Request bytes understood by the adapter on the RS485 link
+ *
+ * Unless stated otherwise, every response ends with a checksum byte that is
+ * the 8-bit sum of the bytes before it. Commands with a payload expect the
+ * payload to be followed by the same kind of checksum.
+ */
+enum class command : std::uint8_t
+{
+  /// Firmware version string, no checksum
+  version = 'v',
+  /// Raw low and high frequency samples, 8 bytes each
+  all_samples = 'a',
+  /// Strongest low frequency diode, see `beacon_report`
+  low = 'l',
+  /// Strongest high frequency diode, see `beacon_report`
+  high = 'h',
+  /// First object block of the latest camera result, 8 bytes
+  camera = 'c',
+  /// Negotiate the protocol version, payload: requested version
+  negotiate = 'n',
+  /// Interpolated bearing, payload: frequency (0 low, 1 high)
+  bearing = 'p',
+  /// Query the diode integration and settle timing
+  timing = 't',
+  /// Override the diode timing, payload: integration us, settle us (u16 LE)
+  set_timing = 'T',
+  /// Start a timing calibration
+  calibrate = 'k',
+  /// Select the sweep mode, payload: 0 sequential, 1 interleaved
+  sweep_mode = 'm',
+  /// Configure oversampling, payload: reading count, filter
+  oversampling = 'o',
+  /// Modeled sweep times of both sweep modes
+  benchmark = 'b',
+  /// High and low beacon reports and the camera block, see `snapshot`
+  snapshot = 's',
+  /// Push snapshots without being asked, payload: period ms (u16 LE), on
+  /// change (0 or 1). A period of 0 stops the pushes.
+  subscribe = 'u',
+  /// Switch the RS485 baud rate, payload: index into `baud_rates`
+  baud_rate = 'r',
+  /// Measured cost of reading the camera over the I2C backend in use
+  camera_benchmark = 'C',
+  /// Age of the camera result 'c' answers with, see `camera_age_version`
+  camera_age = 'g',
+  /// Every object of the latest camera result, payload: most objects to
+  /// return. See `camera_object`.
+  camera_objects = 'd',
+  /// Select the camera algorithm, payload: algorithm ID, see
+  /// `camera_algorithm`
+  camera_algorithm = 'A',
+  /// Camera resynchronisation counters, five u32 LE
+  camera_resync = 'R',
+  /// Adapter metrics, payload: 0 for the error counters, 0xFF for the shared
+  /// overflow histogram, otherwise the command whose latency histogram to
+  /// return
+  metrics = 'M',
+  /// Cost of the profiled firmware zones, payload: reset them afterwards (0 or
+  /// 1)
+  profile = 'P',
+  /// Framed reply to a rejected request, payload: the rejected command
+  nack = 0x15,
+};
+
+/**
+ * @brief Number of payload bytes a request carries
+ *
+ * @param p_command - request command
+ * @return std::size_t - payload length, not counting the legacy checksum. 0
+ * for commands without a payload and unknown commands.
+ */
+inline std::size_t payload_size(command p_command)
+{
+  switch (p_command) {
+    case command::negotiate:
+    case command::bearing:
+    case command::sweep_mode:
+    case command::baud_rate:
+    case command::camera_objects:
+    case command::camera_algorithm:
+    case command::metrics:
+    case command::profile:
+      return 1;
+    case command::oversampling:
+      return 2;
+    case command::subscribe:
+      return 3;
+    case command::set_timing:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+/// Original protocol, 'l' and 'h' reply with 3 bytes holding a 7-bit
+/// intensity with the frequency packed into its top bit.
+constexpr std::uint8_t legacy_version = 1;
+/// 'l' and 'h' reply with a `beacon_report`
+constexpr std::uint8_t compact_version = 2;
+/// Requests and responses may be wrapped in frames, see `frame`
+constexpr std::uint8_t framed_version = 3;
+/// The 's' command is available
+constexpr std::uint8_t snapshot_version = 4;
+/// The 'u' command is available. Pushed snapshots are always sent as frames
+/// with command 's' and a sequence number counting the pushes, with
+/// `pushed_sequence_flag` set.
+constexpr std::uint8_t streaming_version = 5;
+/// The 'r' command is available
+constexpr std::uint8_t baud_rate_version = 6;
+/// The 'g' command is available. The camera is read in the background and
+/// 'c' answers with the latest result without waiting for the camera.
+constexpr std::uint8_t camera_age_version = 7;
+/// The 'd' command is available
+constexpr std::uint8_t camera_objects_version = 8;
+/// The 'A' command is available
+constexpr std::uint8_t camera_algorithm_version = 9;
+/// The 'R' command is available
+constexpr std::uint8_t camera_resync_version = 10;
+/// The 'M' command is available
+constexpr std::uint8_t metrics_version = 11;
+/// The 'P' command is available
+constexpr std::uint8_t profile_version = 12;
+/// Latest protocol version known to this header
+constexpr std::uint8_t latest_version = profile_version;
+
+/**
+ * @brief Camera algorithms that can be selected with 'A'
+ *
+ * Any other ID is passed to the camera as it is. The adapter keeps the latest
+ * result of each recently selected algorithm apart, so after a switch the
+ * camera commands answer with an empty result until the new algorithm's first
+ * result has been read. The response echoes the ID twice.
+ */
+enum class camera_algorithm : std::uint8_t
+{
+  /// Results of whatever algorithm the camera runs, the default
+  any = 0,
+  /// Follow a single learned object
+  object_tracking = 3,
+};
+
+/**
+ * @brief Baud rates the RS485 link can be switched to with 'r'
+ *
+ * The link starts at the first rate. Switching takes two steps so that a rate
+ * that does not work can never strand the link:
+ *
+ * 1. The brain sends 'r' with the rate's index. The adapter acknowledges at
+ *    the current rate, then switches and starts a trial.
+ * 2. The brain switches and sends the same 'r' request at the new rate. The
+ *    adapter acknowledges it, which ends the trial.
+ *
+ * A trial that is not confirmed within `baud_rate_trial_ms` puts the adapter
+ * back on the first rate. A brain whose confirmation gets no answer goes back
+ * to the first rate as well.
+ *
+ * A confirmed rate is kept until the adapter is reset. A brain that restarts
+ * while the adapter stays powered starts on the first rate again, so a brain
+ * whose 'n' gets no answer tries every rate in `baud_rate_probe()` order.
+ */
+constexpr std::uint32_t baud_rates[] = { 115200, 230400, 460800, 921600 };
+/// Number of entries in `baud_rates`
+constexpr std::uint8_t baud_rate_count = 4;
+/// Time the brain has to confirm a new baud rate
+constexpr std::uint32_t baud_rate_trial_ms = 500;
+
+/**
+ * @brief Baud rate to try on an attempt to reach an adapter at an unknown rate
+ *
+ * The brain's current rate is tried first, then the first rate a reset adapter
+ * is on, then the others from the fastest down, since a brain that negotiated
+ * left the adapter on the fastest rate it could.
+ *
+ * @param p_current - index into `baud_rates` the brain is on
+ * @param p_attempt - 0 for the first attempt, up to `baud_rate_count` - 1
+ * @return std::uint8_t - index into `baud_rates` to try, every index is
+ * returned once over the attempts.
+ */
+constexpr std::uint8_t baud_rate_probe(std::uint8_t p_current,
+                                       std::uint8_t p_attempt)
+{
+  if (p_attempt == 0) {
+    return p_current;
+  }
+  if (p_attempt == 1 && p_current != 0) {
+    return 0;
+  }
+  std::uint8_t tried = (p_current == 0) ? 1 : 2;
+  for (std::uint8_t index = baud_rate_count - 1; index > 0; index--) {
+    if (index == p_current) {
+      continue;
+    }
+    if (tried++ == p_attempt) {
+      return index;
+    }
+  }
+  return p_current;
+}
+
+/**
+ * @brief Response to the 'l' and 'h' commands from protocol version 2 onward
+ *
+ * Every field is a single byte so the struct has the same layout on the
+ * adapter and the brain and can be copied straight from the wire.
+ */
+struct beacon_report
+{
+  /// Value of `second_peak` when no second diode is known
+  static constexpr std::uint8_t no_diode = 0xFF;
+
+  /// Index of the strongest diode, 0 (left) to 7 (right)
+  std::uint8_t peak = 0;
+  /// Full 8-bit intensity of the strongest diode
+  std::uint8_t intensity = 0;
+  /// 0 for the low frequency channel, 1 for the high frequency channel
+  std::uint8_t frequency = 0;
+  /// Index of the second strongest diode
+  std::uint8_t second_peak = no_diode;
+  /// Full 8-bit intensity of the second strongest diode
+  std::uint8_t second_intensity = 0;
+  /// Sum of the previous bytes
+  std::uint8_t checksum = 0;
+};
+
+static_assert(sizeof(beacon_report) == 6, "beacon_report must not be padded");
+
+/**
+ * @brief Calculate the checksum of a beacon report
+ *
+ * @param p_report - report to calculate the checksum of
+ * @return constexpr std::uint8_t - 8-bit sum of every field but the checksum
+ */
+constexpr std::uint8_t checksum(beacon_report const& p_report)
+{
+  return static_cast<std::uint8_t>(p_report.peak + p_report.intensity +
+                                   p_report.frequency + p_report.second_peak +
+                                   p_report.second_intensity);
+}
+
+/**
+ * @brief Serialize a beacon report to its wire format
+ *
+ * @param p_report - report to serialize
+ * @return constexpr std::array<std::uint8_t, sizeof(beacon_report)> - bytes
+ */
+constexpr std::array<std::uint8_t, sizeof(beacon_report)> to_bytes(
+  beacon_report const& p_report)
+{
+  return {
+    p_report.peak,        p_report.intensity,        p_report.frequency,
+    p_report.second_peak, p_report.second_intensity, p_report.checksum,
+  };
+}
+
+/**
+ * @brief Response to the 's' command
+ *
+ * Holds everything the brain samples in one response so a refresh takes one
+ * round trip instead of three.
+ */
+struct snapshot
+{
+  /// Latest high frequency report, as returned by 'h'
+  beacon_report high;
+  /// Latest low frequency report, as returned by 'l'
+  beacon_report low;
+  /// Camera block, as returned by 'c' without its checksum
+  std::array<std::uint8_t, 8> camera;
+  /// Sum of the previous bytes
+  std::uint8_t checksum;
+};
+
+static_assert(sizeof(snapshot) == 21, "snapshot must not be padded");
+
+/// Most objects a 'd' response can hold
+constexpr std::uint8_t max_camera_objects = 6;
+
+/**
+ * @brief One object of a 'd' response
+ *
+ * A 'd' request carries the most objects to return, from 1 to
+ * `max_camera_objects`. The response is a count byte followed by that many
+ * `camera_object` entries and a checksum, so its length only depends on the
+ * request. Entries past the count are zero.
+ */
+struct camera_object
+{
+  /// Value of `kind` for a bounding box
+  static constexpr std::uint8_t block = 0;
+  /// Value of `kind` for a line, such as one found by line tracking
+  static constexpr std::uint8_t arrow = 1;
+
+  /// ID the camera learned the object as, 0 if it was not learned
+  std::uint8_t id = 0;
+  /// `block` or `arrow`
+  std::uint8_t kind = block;
+  /// For a block: x center, y center, width and height. For an arrow: x and y
+  /// of the origin followed by x and y of the target. Each value is 16-bit,
+  /// low byte first, in pixels.
+  std::array<std::uint8_t, 8> geometry{};
+};
+
+static_assert(sizeof(camera_object) == 10, "camera_object must not be padded");
+
+/**
+ * @brief Number of bytes in a 'd' response
+ *
+ * @param p_requested - most objects requested
+ * @return constexpr std::size_t - count, objects and checksum
+ */
+constexpr std::size_t camera_objects_size(std::uint8_t p_requested)
+{
+  return 1 + p_requested * sizeof(camera_object) + 1;
+}
+
+/// First byte of every frame, never used as a command byte
+constexpr std::uint8_t frame_sync = 0xA5;
+/// Largest payload a frame may carry
+constexpr std::size_t max_payload_size = 128;
+/// Bytes a frame adds around its payload: sync, length, sequence, command and
+/// the two CRC bytes.
+constexpr std::size_t frame_overhead = 6;
+/// Largest encoded frame
+constexpr std::size_t max_frame_size = max_payload_size + frame_overhead;
+/// Initial value of the frame CRC
+constexpr std::uint16_t crc16_initial = 0xFFFF;
+/// Set in the sequence number of every pushed snapshot. Requests number their
+/// frames without it, so a pushed frame is never taken for a response.
+constexpr std::uint8_t pushed_sequence_flag = 0x80;
+
+/**
+ * @brief Continue a CRC-16/CCITT-FALSE over more bytes
+ *
+ * @param p_data - bytes to add to the CRC
+ * @param p_length - number of bytes in p_data
+ * @param p_crc - CRC of the bytes before p_data
+ * @return std::uint16_t - CRC including p_data
+ */
+inline std::uint16_t crc16(std::uint8_t const* p_data,
+                           std::size_t p_length,
+                           std::uint16_t p_crc = crc16_initial)
+{
+  for (std::size_t i = 0; i < p_length; i++) {
+    p_crc ^= static_cast<std::uint16_t>(p_data[i] << 8);
+    for (int bit = 0; bit < 8; bit++) {
+      bool const carry = (p_crc & 0x8000) != 0;
+      p_crc = static_cast<std::uint16_t>(p_crc << 1);
+      if (carry) {
+        p_crc ^= 0x1021;
+      }
+    }
+  }
+  return p_crc;
+}
+
+/**
+ * @brief A request or response of the framed protocol
+ *
+ * On the wire a frame is laid out as:
+ *
+ *     [sync][length][sequence][command][payload...][crc low][crc high]
+ *
+ * `length` counts only the payload. The CRC covers every byte from `length`
+ * to the end of the payload. A response carries the sequence number and
+ * command of its request and the same bytes, checksum included, that the
+ * unframed command would have replied with.
+ */
+struct frame
+{
+  /// Request counter chosen by the brain and echoed by the adapter
+  std::uint8_t sequence = 0;
+  /// Command byte, see `command`
+  std::uint8_t command = 0;
+  /// Number of valid bytes in `payload`
+  std::uint8_t length = 0;
+  std::array<std::uint8_t, max_payload_size> payload{};
+};
+
+/**
+ * @brief Encode a frame into a buffer
+ *
+ * @param p_sequence - sequence number of the frame
+ * @param p_command - command byte of the frame
+ * @param p_payload - payload bytes
+ * @param p_length - number of payload bytes, at most max_payload_size
+ * @param p_output - buffer of at least p_length + frame_overhead bytes
+ * @return std::size_t - number of bytes written to p_output
+ */
+inline std::size_t encode_frame(std::uint8_t p_sequence,
+                                std::uint8_t p_command,
+                                std::uint8_t const* p_payload,
+                                std::size_t p_length,
+                                std::uint8_t* p_output)
+{
+  p_output[0] = frame_sync;
+  p_output[1] = static_cast<std::uint8_t>(p_length);
+  p_output[2] = p_sequence;
+  p_output[3] = p_command;
+  for (std::size_t i = 0; i < p_length; i++) {
+    p_output[4 + i] = p_payload[i];
+  }
+  auto const crc = crc16(p_output + 1, p_length + 3);
+  p_output[4 + p_length] = static_cast<std::uint8_t>(crc & 0xFF);
+  p_output[5 + p_length] = static_cast<std::uint8_t>(crc >> 8);
+  return p_length + frame_overhead;
+}
+
+/**
+ * @brief Streaming decoder of frames
+ *
+ * Bytes are pushed in as they arrive and may split a frame at any point. A
+ * frame with a bad length or CRC only costs its sync byte: the parser searches
+ * the bytes it already holds for the next sync byte, so a frame that arrived
+ * right behind a damaged one is still decoded.
+ *
+ * Call next() after every push() until it returns false.
+ */
+class frame_parser
+{
+public:
+  /**
+   * @brief Add a received byte
+   *
+   * @param p_byte - byte from the link
+   */
+  void push(std::uint8_t p_byte)
+  {
+    if (m_size == 0 && p_byte != frame_sync) {
+      m_discarded++;
+      return;
+    }
+    if (m_size == m_buffer.size()) {
+      drop(1);
+    }
+    m_buffer[m_size++] = p_byte;
+  }
+
+  /**
+   * @brief Take the next complete frame out of the parser
+   *
+   * @param p_frame - filled with the frame if one is complete
+   * @return true - p_frame holds a frame with a valid CRC
+   */
+  bool next(frame& p_frame)
+  {
+    while (m_size >= 2) {
+      std::size_t const length = m_buffer[1];
+      if (length > max_payload_size) {
+        drop(1);
+        continue;
+      }
+
+      std::size_t const total = length + frame_overhead;
+      if (m_size < total) {
+        return false;
+      }
+
+      auto const crc = crc16(m_buffer.data() + 1, length + 3);
+      auto const received = static_cast<std::uint16_t>(
+        m_buffer[total - 2] | (m_buffer[total - 1] << 8));
+      if (crc != received) {
+        m_crc_errors++;
+        drop(1);
+        continue;
+      }
+
+      p_frame.length = static_cast<std::uint8_t>(length);
+      p_frame.sequence = m_buffer[2];
+      p_frame.command = m_buffer[3];
+      for (std::size_t i = 0; i < length; i++) {
+        p_frame.payload[i] = m_buffer[4 + i];
+      }
+      drop(total);
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Determine if part of a frame has been received
+   *
+   * @return true - bytes following a sync byte are held by the parser
+   */
+  bool in_frame() const
+  {
+    return m_size != 0;
+  }
+
+  /**
+   * @brief Abandon the partially received frame
+   *
+   * The bytes held are counted as discarded.
+   */
+  void reset()
+  {
+    m_discarded += static_cast<std::uint32_t>(m_size);
+    m_size = 0;
+  }
+
+  /**
+   * @brief Number of frames rejected because of a CRC mismatch
+   *
+   * @return std::uint32_t - CRC errors since construction
+   */
+  std::uint32_t crc_errors() const
+  {
+    return m_crc_errors;
+  }
+
+  /**
+   * @brief Number of bytes skipped while searching for a sync byte
+   *
+   * @return std::uint32_t - discarded bytes since construction
+   */
+  std::uint32_t discarded() const
+  {
+    return m_discarded;
+  }
+
+private:
+  // Remove p_count bytes from the front then skip ahead to the next sync byte
+  void drop(std::size_t p_count)
+  {
+    std::size_t start = p_count;
+    while (start < m_size && m_buffer[start] != frame_sync) {
+      start++;
+    }
+    m_discarded += static_cast<std::uint32_t>(start - p_count);
+    for (std::size_t i = start; i < m_size; i++) {
+      m_buffer[i - start] = m_buffer[i];
+    }
+    m_size -= start;
+  }
+
+  std::array<std::uint8_t, max_frame_size> m_buffer{};
+  std::size_t m_size = 0;
+  std::uint32_t m_crc_errors = 0;
+  std::uint32_t m_discarded = 0;
+};
+}  // namespace protocol
+}  // namespace e10
@@ -0,0 +1,113 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <span>
+
+#include <libhal/serial.hpp>
+#include <libhal/units.hpp>
+
+#include "camera_link.hpp"
+#include "camera_poller.hpp"
+
+/**
+ * @brief Requests and responses of the HuskyLens camera protocol
+ *
+ * The camera is reached over a camera_link. Every function may throw the I2C
+ * bus errors of the link, the caller treats those as a lost camera.
+ */
+namespace e10::huskylens {
+/// Camera's I2C address
+constexpr hal::byte camera_address = 0x50;
+/// First and second byte of every request and response
+constexpr hal::byte header1 = 0x55;
+constexpr hal::byte header2 = 0xAA;
+/// Algorithm IDs, requests for any algorithm are answered by the one running
+constexpr hal::byte any_algo = 0x00;
+constexpr hal::byte obj_tracking_algorithm = 0x03;
+
+/// Request and response commands and their payload lengths
+constexpr hal::byte knock_cmd = 0x00;
+constexpr hal::byte knock_length = 0x0A;
+constexpr hal::byte request_blocks_cmd = 0x01;
+constexpr hal::byte block_response = 0x1C;
+constexpr hal::byte arrow_response = 0x1D;
+constexpr hal::byte change_algorithm_cmd = 0x0A;
+constexpr hal::byte change_algorithm_length = 0x0A;
+constexpr hal::byte result_ok = 0x00;
+
+/**
+ * @brief Throw away stale camera data, within the camera link's budget
+ *
+ * @param p_link - camera connection
+ * @param p_console - console for diagnostics
+ */
+void drain_camera(camera_link& p_link, hal::serial& p_console);
+/**
+ * @brief Tell the camera to switch to another algorithm
+ *
+ * @param p_link - camera connection
+ * @param p_algorithm - camera algorithm ID
+ */
+void send_algorithm_change(camera_link& p_link, hal::byte p_algorithm);
+/**
+ * @brief Read the camera's answer to an algorithm change
+ *
+ * @param p_all_data_buffer - buffer for the camera's response
+ * @param p_link - camera connection
+ * @param p_console - console for diagnostics
+ * @param p_algorithm - camera algorithm ID that was sent
+ * @return true - the camera accepted the algorithm
+ */
+bool algorithm_accepted(std::span<hal::byte> p_all_data_buffer,
+                        camera_link& p_link,
+                        hal::serial& p_console,
+                        hal::byte p_algorithm);
+/**
+ * @brief Throw away stale camera data and knock on the camera
+ *
+ * @param p_link - camera connection
+ * @param p_console - console for diagnostics
+ */
+void send_knock(camera_link& p_link, hal::serial& p_console);
+/**
+ * @brief Read the camera's answer to a knock
+ *
+ * @param p_all_data_buffer - buffer for the camera's response
+ * @param p_link - camera connection
+ * @param p_console - console for diagnostics
+ * @return true - the camera answered with OK
+ */
+bool knock_accepted(std::span<hal::byte> p_all_data_buffer,
+                    camera_link& p_link,
+                    hal::serial& p_console);
+/**
+ * @brief Request the camera's latest result and read every object in it
+ *
+ * @param p_all_data_buffer - buffer for the camera responses
+ * @param p_link - camera connection
+ * @param p_console - console for diagnostics
+ * @param p_algorithm - algorithm whose results are requested
+ * @return camera_frame - the first protocol::max_camera_objects
+ * objects and the first block in the 'c' format, empty if the camera reported
+ * nothing or could not be read.
+ */
+camera_frame get_camera_data(std::span<hal::byte> p_all_data_buffer,
+                             camera_link& p_link,
+                             hal::serial& p_console,
+                             hal::byte p_algorithm);
+std::span<hal::byte> read_response_data(std::span<hal::byte> p_all_data_buffer,
+                                        camera_link& p_link);
+}  // namespace e10::huskylens
@@ -0,0 +1,111 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <libhal/steady_clock.hpp>
+#include <libhal/units.hpp>
+
+#include "e10_protocol.hpp"
+
+namespace e10 {
+/**
+ * @brief Adapter side of the RS485 baud rate negotiation
+ *
+ * Tracks which of protocol::baud_rates the link should run at. The owner of
+ * the serial port applies rate() whenever it changes, after the response to
+ * the request that changed it has been sent. See protocol::baud_rates for the
+ * handshake.
+ */
+class link_rate
+{
+public:
+  /// Outcome of a baud rate request
+  enum class outcome : hal::u8
+  {
+    /// Unknown rate, nothing changed
+    rejected,
+    /// The rate is used from now on but must still be confirmed
+    trial_started,
+    /// The rate of the running trial was confirmed
+    confirmed,
+  };
+
+  /**
+   * @brief Construct a new link rate at the first baud rate
+   *
+   * @param p_clock - clock used to time the trial
+   */
+  link_rate(hal::steady_clock& p_clock)
+    : m_clock(&p_clock)
+  {
+    m_trial_ticks = static_cast<hal::u64>(
+      p_clock.frequency() * protocol::baud_rate_trial_ms / 1000.0f);
+  }
+
+  /**
+   * @brief Handle a baud rate request from the brain
+   *
+   * @param p_index - index into protocol::baud_rates
+   * @return outcome - what the request did
+   */
+  outcome request(hal::u8 p_index)
+  {
+    if (p_index >= protocol::baud_rate_count) {
+      return outcome::rejected;
+    }
+    if (m_in_trial && p_index == m_index) {
+      m_in_trial = false;
+      return outcome::confirmed;
+    }
+    m_index = p_index;
+    m_in_trial = true;
+    m_deadline = m_clock->uptime() + m_trial_ticks;
+    return outcome::trial_started;
+  }
+
+  /**
+   * @brief Go back to the first baud rate if the trial was not confirmed in
+   * time
+   *
+   * @return true - the trial expired and the rate was reverted
+   */
+  bool revert_if_expired()
+  {
+    if (not m_in_trial || m_clock->uptime() < m_deadline) {
+      return false;
+    }
+    m_in_trial = false;
+    m_index = 0;
+    return true;
+  }
+
+  /**
+   * @brief Baud rate the link must run at
+   *
+   * @return hal::u32 - baud rate in bits per second
+   */
+  hal::u32 rate() const
+  {
+    return protocol::baud_rates[m_index];
+  }
+
+private:
+  hal::steady_clock* m_clock;
+  hal::u64 m_trial_ticks = 0;
+  hal::u64 m_deadline = 0;
+  hal::u8 m_index = 0;
+  bool m_in_trial = false;
+};
+}  // namespace e10
@@ -0,0 +1,196 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <span>
+
+#include <libhal-util/serial.hpp>
+#include <libhal/serial.hpp>
+#include <libhal/units.hpp>
+
+// Lowest level of log message compiled into the firmware, see e10::log_level
+#if not defined(E10_LOG_LEVEL)
+#define E10_LOG_LEVEL 2
+#endif
+
+namespace e10 {
+/**
+ * @brief Importance of a log message
+ *
+ */
+enum class log_level : hal::u8
+{
+  /// Raw bus traffic, such as every byte read from the camera
+  trace = 0,
+  /// Per command diagnostics, such as command timing
+  debug = 1,
+  /// Notable events, such as reconnecting the camera
+  info = 2,
+  /// Recoverable errors, such as a rejected payload
+  warning = 3,
+  /// Disables every log message
+  none = 4,
+};
+
+/// Messages below this level are removed at compile time
+constexpr auto compiled_log_level = static_cast<log_level>(E10_LOG_LEVEL);
+
+/**
+ * @brief Print a log message if its level is compiled in
+ *
+ * Messages below `compiled_log_level` compile down to nothing.
+ *
+ * @tparam Level - importance of the message
+ * @tparam BufferSize - size of the buffer the message is formatted into
+ * @param p_serial - serial port to print to
+ * @param p_format - printf style format string
+ * @param p_parameters - values for the format string
+ */
+template<log_level Level, std::size_t BufferSize = 64, typename... Parameters>
+void log(hal::serial& p_serial,
+         char const* p_format,
+         Parameters... p_parameters)
+{
+  if constexpr (Level >= compiled_log_level) {
+    hal::print<BufferSize>(p_serial, p_format, p_parameters...);
+  }
+}
+
+/**
+ * @brief Serial port that holds written data until there is time to send it
+ *
+ * Writes are copied into a ring buffer and return immediately, so printing
+ * never holds up a command waiting on a slow console baud rate. The main loop
+ * calls drain() when it is idle to pass a few buffered bytes on to the real
+ * port at a time. The real port must only take the bytes it can send without
+ * waiting, the rest stays in the ring for the next drain. A write that does
+ * not fit in the free space is dropped as a whole so that messages are never
+ * cut in half.
+ *
+ * The ring is lock free for a single writer and a single drainer. Reads,
+ * configuration and flushes are passed straight through.
+ *
+ * @tparam Capacity - number of bytes the ring can hold
+ */
+template<std::size_t Capacity>
+class deferred_serial : public hal::serial
+{
+public:
+  /// Bytes passed on by drain() unless told otherwise
+  static constexpr std::size_t default_drain_size = 16;
+
+  /**
+   * @brief Construct a new deferred serial
+   *
+   * @param p_serial - serial port the buffered data is eventually written to
+   */
+  deferred_serial(hal::serial& p_serial)
+    : m_serial(&p_serial)
+  {
+  }
+
+  /**
+   * @brief Pass some of the buffered data on to the serial port
+   *
+   * Makes a single write to the serial port. Bytes the port did not take are
+   * offered again on the next drain.
+   *
+   * @param p_max_bytes - most bytes to offer the serial port
+   * @return std::size_t - number of bytes the serial port took, 0 if the ring
+   * is empty or the port is busy
+   */
+  std::size_t drain(std::size_t p_max_bytes = default_drain_size)
+  {
+    auto const tail = m_tail.load(std::memory_order_relaxed);
+    auto const head = m_head.load(std::memory_order_acquire);
+    auto const offset = tail % Capacity;
+    // Only write up to the end of the ring, the rest goes on the next drain
+    auto const length =
+      std::min({ head - tail, p_max_bytes, Capacity - offset });
+    if (length == 0) {
+      return 0;
+    }
+
+    auto const result =
+      m_serial->write(std::span(m_buffer).subspan(offset, length));
+    auto const taken = result.data.size();
+    m_tail.store(tail + taken, std::memory_order_release);
+    return taken;
+  }
+
+  /**
+   * @brief Determine if every written byte has been passed on
+   *
+   * @return true - the ring is empty
+   */
+  bool empty() const
+  {
+    return m_head.load(std::memory_order_acquire) ==
+           m_tail.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Number of bytes dropped because the ring was full
+   *
+   * @return std::size_t - dropped bytes since construction
+   */
+  std::size_t dropped() const
+  {
+    return m_dropped.load(std::memory_order_relaxed);
+  }
+
+private:
+  void driver_configure(settings const& p_settings) override
+  {
+    m_serial->configure(p_settings);
+  }
+
+  write_t driver_write(std::span<hal::byte const> p_data) override
+  {
+    auto const head = m_head.load(std::memory_order_relaxed);
+    auto const tail = m_tail.load(std::memory_order_acquire);
+    if (p_data.size() > Capacity - (head - tail)) {
+      m_dropped.fetch_add(p_data.size(), std::memory_order_relaxed);
+      return { .data = p_data };
+    }
+
+    for (std::size_t i = 0; i < p_data.size(); i++) {
+      m_buffer[(head + i) % Capacity] = p_data[i];
+    }
+    m_head.store(head + p_data.size(), std::memory_order_release);
+    return { .data = p_data };
+  }
+
+  read_t driver_read(std::span<hal::byte> p_data) override
+  {
+    return m_serial->read(p_data);
+  }
+
+  void driver_flush() override
+  {
+    m_serial->flush();
+  }
+
+  hal::serial* m_serial;
+  std::array<hal::byte, Capacity> m_buffer{};
+  std::atomic<std::size_t> m_head = 0;
+  std::atomic<std::size_t> m_tail = 0;
+  std::atomic<std::size_t> m_dropped = 0;
+};
+}  // namespace e10
@@ -0,0 +1,258 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#if not defined(__arm__)
+#include <chrono>
+#include <mutex>
+#endif
+
+// Profiling zones compiled in (1) or out (0), off by default in release builds
+#if not defined(E10_PROFILING)
+#if defined(NDEBUG)
+#define E10_PROFILING 0
+#else
+#define E10_PROFILING 1
+#endif
+#endif
+
+namespace e10 {
+/**
+ * @brief Code paths whose cost is profiled
+ *
+ */
+enum class profile_zone : std::uint8_t
+{
+  /// Diode scanner steps run from one sequencer timer interrupt
+  diode_step,
+  /// Reading one response from the camera, see read_response_data()
+  camera_response,
+  /// Requesting and reading a full camera result, see get_camera_data()
+  camera_read,
+  /// Number of zones, not a zone
+  count,
+};
+
+/// Number of profiled zones
+constexpr std::size_t profile_zone_count =
+  static_cast<std::size_t>(profile_zone::count);
+
+/// Names of the zones, in the order of profile_zone
+constexpr std::array<char const*, profile_zone_count> profile_zone_names{
+  "diode_step",
+  "camera_response",
+  "camera_read",
+};
+
+/// Profiling scopes record their zone
+constexpr bool profiling_enabled = E10_PROFILING != 0;
+
+/**
+ * @brief Cost of a profiled zone
+ *
+ * Times are in profile counter ticks, see profile_counter().
+ */
+struct profile_stats
+{
+  /// Times the zone was run
+  std::uint32_t count = 0;
+  /// Shortest run
+  std::uint32_t min = UINT32_MAX;
+  /// Longest run
+  std::uint32_t max = 0;
+  /// Sum of every run
+  std::uint64_t total = 0;
+};
+
+/// Cost of every zone, indexed by profile_zone
+using profile_stats_table = std::array<profile_stats, profile_zone_count>;
+
+/**
+ * @brief Cost of every zone since startup or the last profile_reset()
+ *
+ * Each zone must only be recorded from one context, either the main loop or
+ * one interrupt. The main loop reads it through profile_snapshot(), a direct
+ * read of a zone recorded in an interrupt may see a run half recorded.
+ */
+inline profile_stats_table profile_table{};
+
+#if defined(__arm__)
+/**
+ * @brief Keeps interrupts from recording while the table is accessed
+ *
+ * Masks every interrupt with PRIMASK for the lifetime of the lock and
+ * restores the previous mask afterwards, so it may be nested.
+ */
+class profile_lock
+{
+public:
+  profile_lock()
+  {
+    asm volatile("mrs %0, primask" : "=r"(m_primask));
+    asm volatile("cpsid i" ::: "memory");
+  }
+
+  profile_lock(profile_lock const&) = delete;
+  profile_lock& operator=(profile_lock const&) = delete;
+
+  ~profile_lock()
+  {
+    asm volatile("msr primask, %0" : : "r"(m_primask) : "memory");
+  }
+
+private:
+  std::uint32_t m_primask;
+};
+#else
+/// Serialises the host's interrupt threads with the main loop
+inline std::mutex profile_mutex;
+
+/**
+ * @brief Keeps interrupts from recording while the table is accessed
+ *
+ * The host runs its interrupts on threads, which profile_record() keeps out
+ * with the same mutex.
+ */
+class profile_lock
+{
+private:
+  std::lock_guard<std::mutex> m_guard{ profile_mutex };
+};
+#endif
+
+/// Ticks per second of profile_counter() on the host
+constexpr std::uint32_t host_profile_frequency = 1'000'000'000;
+
+/**
+ * @brief Free running counter the zones are timed with
+ *
+ * On Cortex-M this is the DWT cycle counter, which runs at the CPU frequency
+ * once resources::clock() has enabled it. On the host it is
+ * std::chrono::steady_clock in nanoseconds. Wraps around, only differences
+ * are meaningful.
+ *
+ * @return std::uint32_t - current count
+ */
+inline std::uint32_t profile_counter()
+{
+#if defined(__arm__)
+  // DWT->CYCCNT
+  return *reinterpret_cast<std::uint32_t volatile*>(0xE0001004);
+#else
+  auto const now = std::chrono::steady_clock::now().time_since_epoch();
+  return static_cast<std::uint32_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+#endif
+}
+
+/**
+ * @brief Ticks per second of profile_counter()
+ *
+ * @param p_cpu_frequency - CPU frequency in Hz, the rate of the DWT counter
+ * @return std::uint32_t - ticks per second
+ */
+inline std::uint32_t profile_frequency([[maybe_unused]] float p_cpu_frequency)
+{
+#if defined(__arm__)
+  return static_cast<std::uint32_t>(p_cpu_frequency);
+#else
+  return host_profile_frequency;
+#endif
+}
+
+/**
+ * @brief Add a run to a zone
+ *
+ * @param p_zone - zone that was run
+ * @param p_ticks - duration of the run in profile counter ticks
+ */
+inline void profile_record(profile_zone p_zone, std::uint32_t p_ticks)
+{
+#if not defined(__arm__)
+  profile_lock const lock;
+#endif
+  auto& stats = profile_table[static_cast<std::size_t>(p_zone)];
+  stats.count++;
+  stats.min = std::min(stats.min, p_ticks);
+  stats.max = std::max(stats.max, p_ticks);
+  stats.total += p_ticks;
+}
+
+/**
+ * @brief Copy of the cost of every zone
+ *
+ * Safe to call from the main loop while interrupts record zones.
+ *
+ * @return profile_stats_table - cost of every zone
+ */
+inline profile_stats_table profile_snapshot()
+{
+  profile_lock const lock;
+  return profile_table;
+}
+
+/**
+ * @brief Clear the cost of every zone
+ *
+ * Safe to call from the main loop while interrupts record zones.
+ */
+inline void profile_reset()
+{
+  profile_lock const lock;
+  profile_table.fill({});
+}
+
+/**
+ * @brief Records the time from its construction to its destruction in a zone
+ *
+ * Compiles down to nothing unless E10_PROFILING is set. A scope that is left
+ * by an exception still records its run.
+ */
+class profile_scope
+{
+public:
+  /**
+   * @brief Start timing a run of a zone
+   *
+   * @param p_zone - zone to record the run in
+   */
+  explicit profile_scope([[maybe_unused]] profile_zone p_zone)
+#if E10_PROFILING
+    : m_zone(p_zone)
+    , m_start(profile_counter())
+#endif
+  {
+  }
+
+  profile_scope(profile_scope const&) = delete;
+  profile_scope& operator=(profile_scope const&) = delete;
+
+#if E10_PROFILING
+  ~profile_scope()
+  {
+    profile_record(m_zone, profile_counter() - m_start);
+  }
+
+private:
+  profile_zone m_zone;
+  std::uint32_t m_start;
+#endif
+};
+}  // namespace e10
@@ -0,0 +1,101 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+#include <libhal/adc.hpp>
+#include <libhal/steady_clock.hpp>
+#include <libhal/units.hpp>
+
+namespace e10 {
+/**
+ * @brief Tracks the IRB reference voltage divider at a low rate
+ *
+ * The reference divider only drifts slowly with supply voltage and
+ * temperature, so converting it for every sweep wastes time and passes its
+ * conversion noise straight into the mapping of every diode. The tracker
+ * converts it at most once per period and smooths the readings with an
+ * exponential moving average.
+ */
+class reference_tracker
+{
+public:
+  /// Default time between reference conversions
+  static constexpr hal::time_duration default_period =
+    std::chrono::milliseconds(250);
+  /// Weight of each new reading in the moving average
+  static constexpr float smoothing = 0.25f;
+
+  /**
+   * @brief Construct a new reference tracker
+   *
+   * @param p_reference - adc connected to the reference voltage divider
+   * @param p_clock - clock used to pace the conversions
+   * @param p_period - minimum time between conversions
+   */
+  reference_tracker(hal::adc& p_reference,
+                    hal::steady_clock& p_clock,
+                    hal::time_duration p_period = default_period)
+    : m_reference(&p_reference)
+    , m_clock(&p_clock)
+  {
+    auto const ticks_per_ns = p_clock.frequency() / 1e9f;
+    m_period = static_cast<hal::u64>(static_cast<float>(p_period.count()) *
+                                     ticks_per_ns);
+  }
+
+  /**
+   * @brief Convert the reference if a period has passed since the last one
+   *
+   * The first call always converts and seeds the average with the reading.
+   */
+  void update()
+  {
+    auto const now = m_clock->uptime();
+    if (m_seeded && now < m_next_conversion) {
+      return;
+    }
+
+    auto const reading = m_reference->read();
+    auto const previous = m_value.load(std::memory_order_relaxed);
+    auto const smoothed =
+      m_seeded ? previous + smoothing * (reading - previous) : reading;
+
+    m_value.store(smoothed, std::memory_order_relaxed);
+    m_seeded = true;
+    m_next_conversion = now + m_period;
+  }
+
+  /**
+   * @brief Smoothed reference reading
+   *
+   * @return float - reference ratio, 0.0f until the first update()
+   */
+  float value() const
+  {
+    return m_value.load(std::memory_order_relaxed);
+  }
+
+private:
+  hal::adc* m_reference;
+  hal::steady_clock* m_clock;
+  hal::u64 m_period = 0;
+  hal::u64 m_next_conversion = 0;
+  std::atomic<float> m_value = 0.0f;
+  bool m_seeded = false;
+};
+}  // namespace e10
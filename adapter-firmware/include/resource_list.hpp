@@ -16,13 +16,21 @@
 
 #include <optional>
 
+#if defined(__arm__)
 #include <libhal-arm-mcu/system_control.hpp>
+#endif
 #include <libhal/adc.hpp>
 #include <libhal/functional.hpp>
 #include <libhal/i2c.hpp>
 #include <libhal/output_pin.hpp>
 #include <libhal/serial.hpp>
 #include <libhal/steady_clock.hpp>
+#include <libhal/timer.hpp>
+
+// Camera I2C backend, 0 bit banged on PB6/PB7 or 1 for the I2C1 peripheral
+#if not defined(E10_HARDWARE_I2C)
+#define E10_HARDWARE_I2C 0
+#endif
 
 namespace custom {
 /**
@@ -65,19 +73,59 @@ std::pmr::polymorphic_allocator<> driver_allocator();
  */
 hal::v5::strong_ptr<hal::steady_clock> clock();
 hal::v5::strong_ptr<hal::serial> console();
+/**
+ * @brief Serial port connected to the RS485 transceiver
+ *
+ * Drives the transceiver's direction pin itself: each write switches the
+ * transceiver to send and returns it to receive as soon as the last byte has
+ * left the UART. Every response must therefore be written with a single
+ * write so the bus is not released in the middle of it.
+ *
+ * @return hal::v5::strong_ptr<hal::serial>
+ */
 hal::v5::strong_ptr<hal::serial> rs485_transceiver();
 hal::v5::strong_ptr<hal::adc> intensity();
 hal::v5::strong_ptr<hal::adc> adc_reference();
+/**
+ * @brief I2C bus of the camera
+ *
+ * Bit banged unless the platform is built with E10_HARDWARE_I2C set, in which
+ * case the MCU's I2C peripheral on the same pins runs the bus at 400kHz.
+ *
+ * @return hal::v5::strong_ptr<hal::i2c>
+ */
 hal::v5::strong_ptr<hal::i2c> i2c();
 hal::v5::strong_ptr<hal::output_pin> counter_reset();
 hal::v5::strong_ptr<hal::output_pin> counter_clock();
 hal::v5::strong_ptr<hal::output_pin> transceiver_direction();
 hal::v5::strong_ptr<hal::output_pin> frequency_select();
+/**
+ * @brief Timer whose interrupt steps the photo diode multiplexer sequence
+ *
+ * @return hal::v5::strong_ptr<hal::timer>
+ */
+hal::v5::strong_ptr<hal::timer> sequencer_timer();
+/**
+ * @brief Sleep the CPU until there may be new work for the main loop
+ *
+ * Returns after any interrupt, such as the sequencer timer's, or once a byte
+ * is received on the console or the RS485 transceiver. May return early, the
+ * caller must check for work itself.
+ */
+void wait_for_work();
 
+#if defined(__arm__)
 inline void reset()
 {
   hal::cortex_m::reset();
 }
+#else
+/**
+ * @brief Restart the adapter, the host platform ends the process instead
+ *
+ */
+void reset();
+#endif
 inline void sleep(hal::time_duration p_duration)
 {
   auto delay_clock = resources::clock();
@@ -0,0 +1,84 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <numeric>
+#include <span>
+
+#include <libhal/units.hpp>
+
+namespace e10 {
+/**
+ * @brief Method used to reduce a burst of ADC readings down to one value
+ *
+ */
+enum class sample_filter : hal::u8
+{
+  /// Average of every reading
+  mean = 0,
+  /// Middle reading, rejects single conversion spikes
+  median = 1,
+  /// Average of the middle half of the readings
+  trimmed_mean = 2,
+};
+
+/**
+ * @brief Settings for the burst read of each diode
+ *
+ */
+struct oversampling
+{
+  /// Most readings that can be taken per diode
+  static constexpr hal::u8 max_count = 16;
+
+  /// Number of readings taken per diode, 1 to max_count
+  hal::u8 count = 1;
+  /// Reduction applied to the readings
+  sample_filter filter = sample_filter::mean;
+};
+
+/**
+ * @brief Reduce a burst of readings down to a single reading
+ *
+ * @param p_readings - readings to reduce, may be reordered. Must not be empty.
+ * @param p_filter - reduction to apply
+ * @return float - filtered reading
+ */
+inline float reduce(std::span<float> p_readings, sample_filter p_filter)
+{
+  auto const mean = [](std::span<float> p_range) {
+    return std::accumulate(p_range.begin(), p_range.end(), 0.0f) /
+           static_cast<float>(p_range.size());
+  };
+
+  switch (p_filter) {
+    case sample_filter::median: {
+      auto const middle = p_readings.begin() + p_readings.size() / 2;
+      std::nth_element(p_readings.begin(), middle, p_readings.end());
+      return *middle;
+    }
+    case sample_filter::trimmed_mean: {
+      // Drop the lowest and highest quarter of the readings
+      std::ranges::sort(p_readings);
+      auto const trim = p_readings.size() / 4;
+      return mean(p_readings.subspan(trim, p_readings.size() - 2 * trim));
+    }
+    case sample_filter::mean:
+    default:
+      return mean(p_readings);
+  }
+}
+}  // namespace e10
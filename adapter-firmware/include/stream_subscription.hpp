@@ -0,0 +1,114 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <libhal/serial.hpp>
+#include <libhal/steady_clock.hpp>
+#include <libhal/units.hpp>
+
+#include "e10_protocol.hpp"
+
+namespace e10 {
+/**
+ * @brief Snapshots pushed to a subscriber without being requested
+ *
+ * The main loop asks due() whenever it is idle and, if so, pushes a snapshot
+ * to port() and reports it with pushed(). Snapshots are spaced by at least the
+ * subscribed period and, if requested, wait for a new sweep. The first
+ * snapshot after subscribing is due right away. On a half-duplex link the
+ * main loop also holds a due snapshot back while a request is arriving.
+ */
+class stream_subscription
+{
+public:
+  /**
+   * @brief Construct a new subscription with nobody subscribed
+   *
+   * @param p_clock - clock used to space the snapshots
+   */
+  stream_subscription(hal::steady_clock& p_clock)
+    : m_clock(&p_clock)
+  {
+  }
+
+  /**
+   * @brief Replace the subscription
+   *
+   * @param p_port - port receiving the snapshots
+   * @param p_period_ms - least time between two snapshots, 0 cancels the
+   * subscription
+   * @param p_on_change - only push a snapshot once a new sweep has completed
+   */
+  void subscribe(hal::serial& p_port, hal::u16 p_period_ms, bool p_on_change)
+  {
+    m_port = (p_period_ms != 0) ? &p_port : nullptr;
+    m_period = static_cast<hal::u64>(static_cast<float>(p_period_ms) *
+                                     m_clock->frequency() / 1000.0f);
+    m_on_change = p_on_change;
+    m_next_push = 0;
+    m_last_sweeps = 0;
+  }
+
+  /**
+   * @brief Determine if a snapshot should be pushed
+   *
+   * @param p_sweeps - sweeps completed on both frequencies so far
+   * @return true - someone is subscribed, the period has passed and, if
+   * requested, a new sweep has completed since the last snapshot.
+   */
+  bool due(hal::u32 p_sweeps) const
+  {
+    if (m_port == nullptr || m_clock->uptime() < m_next_push) {
+      return false;
+    }
+    return not m_on_change || p_sweeps != m_last_sweeps;
+  }
+
+  /**
+   * @brief Record that a snapshot is being pushed
+   *
+   * @param p_sweeps - sweeps completed on both frequencies so far
+   * @return hal::byte - sequence number of the snapshot's frame, the push
+   * count in the low 7 bits with protocol::pushed_sequence_flag set
+   */
+  hal::byte pushed(hal::u32 p_sweeps)
+  {
+    m_next_push = m_clock->uptime() + m_period;
+    m_last_sweeps = p_sweeps;
+    m_pushes++;
+    return static_cast<hal::byte>(protocol::pushed_sequence_flag |
+                                  (m_pushes % protocol::pushed_sequence_flag));
+  }
+
+  /**
+   * @brief Port receiving the snapshots
+   *
+   * @return hal::serial* - subscribed port, nullptr if nobody is subscribed
+   */
+  hal::serial* port() const
+  {
+    return m_port;
+  }
+
+private:
+  hal::steady_clock* m_clock;
+  hal::serial* m_port = nullptr;
+  hal::u64 m_period = 0;
+  hal::u64 m_next_push = 0;
+  hal::u32 m_last_sweeps = 0;
+  hal::byte m_pushes = 0;
+  bool m_on_change = false;
+};
+}  // namespace e10
@@ -0,0 +1,612 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Simulated adapter hardware so application() runs as a Linux process.
+//
+// - The console and RS485 link are pseudo terminals, their paths are printed
+//   to stderr at startup.
+// - The photo diode multiplexer follows the counter pins driven by the diode
+//   scanner and the intensity ADC reads the selected diode of a simulated
+//   beacon per frequency. Like the analog front end, the reading settles
+//   exponentially towards the new diode after every pin change.
+// - The camera answers the firmware's camera protocol on the I2C bus.
+// - The sequencer timer runs its callbacks on a thread, standing in for the
+//   timer interrupt.
+//
+// The beacons and the camera are driven by the script named by the
+// E10_HOST_SCRIPT environment variable, one event per line:
+//
+//   <time ms> low <diode> <strength>          beacon on the low frequency
+//   <time ms> high <diode> <strength>         beacon on the high frequency
+//   <time ms> block <id> <x> <y> <w> <h>      camera reports a block
+//   <time ms> arrow <id> <x0> <y0> <x1> <y1>  camera reports an arrow
+//   <time ms> clear                           camera reports nothing
+//   <time ms> unplug                          camera stops answering
+//   <time ms> plug                            camera answers again
+//   <time ms> garbage <count>                 junk before the next response
+//
+// Times are milliseconds since startup. Strengths are fractions of the
+// reference voltage. Lines starting with '#' are ignored.
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory_resource>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <libhal-util/steady_clock.hpp>
+#include <libhal/error.hpp>
+#include <libhal/pointers.hpp>
+#include <libhal/units.hpp>
+
+#include <resource_list.hpp>
+
+#include "host_camera.hpp"
+
+namespace resources {
+namespace {
+/// Ticks per second of the simulated uptime clock
+constexpr hal::hertz host_clock_frequency = 1e9f;
+/// Reference voltage divider reading, as a fraction of the ADC's full scale
+constexpr float reference_reading = 0.75f;
+/// Intensity every diode reads without a beacon, relative to the reference
+constexpr float ambient = 0.02f;
+/// Time constant of the intensity's first order settle after a pin change
+constexpr float settle_time_constant_ns = 500'000.0f;
+
+auto const start_time = std::chrono::steady_clock::now();
+
+hal::u64 uptime_ns()
+{
+  return static_cast<hal::u64>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start_time)
+      .count());
+}
+
+/**
+ * @brief A timed event of the simulation script
+ *
+ */
+struct script_event
+{
+  hal::u64 at_ms = 0;
+  std::string action;
+  std::array<int, 5> values{};
+  float strength = 0.0f;
+};
+
+/**
+ * @brief State of the simulated world, shared by every simulated driver
+ *
+ * Script events are applied lazily by whichever driver touches the state
+ * first once they are due.
+ */
+class simulation
+{
+public:
+  void load(char const* p_path)
+  {
+    std::ifstream file(p_path);
+    if (not file) {
+      std::fprintf(stderr, "host: cannot open script '%s'\n", p_path);
+      return;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+      if (line.empty() || line.front() == '#') {
+        continue;
+      }
+      std::istringstream fields(line);
+      script_event event{};
+      fields >> event.at_ms >> event.action;
+      if (event.action == "low" || event.action == "high") {
+        fields >> event.values[0] >> event.strength;
+      } else {
+        for (auto& value : event.values) {
+          fields >> value;
+        }
+      }
+      m_events.push_back(event);
+    }
+    std::ranges::stable_sort(m_events, {}, &script_event::at_ms);
+  }
+
+  /// Mutex guarding every member, taken by the drivers around each access
+  std::mutex& lock()
+  {
+    return m_mutex;
+  }
+
+  /// Apply the script events that are due, the lock must be held
+  void update()
+  {
+    auto const now_ms = uptime_ns() / 1'000'000;
+    while (m_next_event < m_events.size() &&
+           m_events[m_next_event].at_ms <= now_ms) {
+      apply(m_events[m_next_event++]);
+    }
+  }
+
+  /// Intensity reading the analog front end settles to, the lock must be held
+  float intensity_target() const
+  {
+    if (counter_reset || falling_edges == 0) {
+      return ambient * reference_reading;
+    }
+    // The diode sampled after the N-th falling edge is diode N - 1
+    auto const diode = static_cast<int>((falling_edges - 1) % 8);
+    auto const& beacon = beacons[high_frequency ? 1 : 0];
+    // The diodes are a row, not a ring, the end diodes only have one
+    // neighbour as in interpolate_bearing()
+    auto const distance = std::abs(diode - beacon.diode);
+    constexpr std::array<float, 8> falloff{ 1.0f, 0.5f, 0.15f };
+    auto const level = ambient + beacon.strength * falloff[distance];
+    return std::min(level, 1.0f) * reference_reading;
+  }
+
+  /// Intensity reading right now, part way from the level at the last pin
+  /// change to intensity_target(). The lock must be held.
+  float intensity() const
+  {
+    auto const elapsed = static_cast<float>(uptime_ns() - m_settle_start);
+    auto const target = intensity_target();
+    auto const remaining = std::exp(-elapsed / settle_time_constant_ns);
+    return target + (m_settle_from - target) * remaining;
+  }
+
+  /// Start settling from the current reading, called before a pin changes the
+  /// selected diode, the reset or the frequency. The lock must be held.
+  void begin_settle()
+  {
+    m_settle_from = intensity();
+    m_settle_start = uptime_ns();
+  }
+
+  // Photo diode multiplexer, a counter that resets to the first diode and
+  // steps on every falling edge of the counter clock.
+  bool counter_reset = true;
+  bool counter_clock = true;
+  bool high_frequency = false;
+  hal::u32 falling_edges = 0;
+
+  struct beacon
+  {
+    int diode = 0;
+    float strength = 0.0f;
+  };
+  std::array<beacon, 2> beacons{ beacon{ .diode = 2, .strength = 0.5f },
+                                 beacon{ .diode = 5, .strength = 0.7f } };
+
+  e10::host::simulated_camera camera{};
+
+private:
+  void apply(script_event const& p_event)
+  {
+    auto const& v = p_event.values;
+    auto const u16 = [](int p_value) {
+      return static_cast<hal::u16>(std::clamp(p_value, 0, 0xFFFF));
+    };
+    if (p_event.action == "low" || p_event.action == "high") {
+      auto& target = beacons[p_event.action == "high" ? 1 : 0];
+      target = { .diode = std::clamp(v[0], 0, 7),
+                 .strength = p_event.strength };
+    } else if (p_event.action == "block" || p_event.action == "arrow") {
+      camera.add_object({
+        .command = hal::byte(p_event.action == "block" ? 0x1C : 0x1D),
+        .id = static_cast<hal::byte>(v[0]),
+        .geometry = { u16(v[1]), u16(v[2]), u16(v[3]), u16(v[4]) },
+      });
+    } else if (p_event.action == "clear") {
+      camera.clear_objects();
+    } else if (p_event.action == "unplug") {
+      camera.plug(false);
+    } else if (p_event.action == "plug") {
+      camera.plug(true);
+    } else if (p_event.action == "garbage") {
+      camera.add_garbage(static_cast<hal::u32>(std::max(v[0], 0)));
+    } else {
+      std::fprintf(
+        stderr, "host: unknown script action '%s'\n", p_event.action.c_str());
+    }
+  }
+
+  std::mutex m_mutex;
+  std::vector<script_event> m_events;
+  std::size_t m_next_event = 0;
+  float m_settle_from = ambient * reference_reading;
+  hal::u64 m_settle_start = 0;
+};
+
+simulation world;
+
+class host_clock : public hal::steady_clock
+{
+private:
+  hal::hertz driver_frequency() override
+  {
+    return host_clock_frequency;
+  }
+
+  hal::u64 driver_uptime() override
+  {
+    return uptime_ns();
+  }
+};
+
+/**
+ * @brief Serial port on the master side of a pseudo terminal
+ *
+ * Never blocks: reads return what has arrived and writes that nobody is
+ * reading are dropped once the terminal's buffer is full, like bytes sent
+ * down a UART nobody listens to.
+ */
+class pty_serial : public hal::serial
+{
+public:
+  pty_serial(char const* p_name)
+  {
+    m_master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (m_master < 0 || grantpt(m_master) != 0 || unlockpt(m_master) != 0) {
+      std::perror("host: posix_openpt");
+      std::exit(EXIT_FAILURE);
+    }
+    termios settings{};
+    tcgetattr(m_master, &settings);
+    cfmakeraw(&settings);
+    tcsetattr(m_master, TCSANOW, &settings);
+
+    char const* const path = ptsname(m_master);
+    // Hold the terminal open so the master does not hang up between clients
+    m_slave = open(path, O_RDWR | O_NOCTTY);
+    std::fprintf(stderr, "host: %s on %s\n", p_name, path);
+  }
+
+  pty_serial(pty_serial const&) = delete;
+  pty_serial& operator=(pty_serial const&) = delete;
+
+  ~pty_serial() override
+  {
+    close(m_slave);
+    close(m_master);
+  }
+
+  int fd() const
+  {
+    return m_master;
+  }
+
+private:
+  /// Receive buffer size reported to the readers, bytes past it are lost
+  static constexpr std::size_t receive_capacity = 4096;
+
+  void driver_configure(settings const&) override
+  {
+    // Pseudo terminals move bytes at any baud rate
+  }
+
+  write_t driver_write(std::span<hal::byte const> p_data) override
+  {
+    auto remaining = p_data;
+    while (not remaining.empty()) {
+      auto const written = ::write(m_master, remaining.data(), remaining.size());
+      if (written <= 0) {
+        break;
+      }
+      remaining = remaining.subspan(static_cast<std::size_t>(written));
+    }
+    return { .data = p_data };
+  }
+
+  read_t driver_read(std::span<hal::byte> p_data) override
+  {
+    auto const received = ::read(m_master, p_data.data(), p_data.size());
+    auto const length = received > 0 ? static_cast<std::size_t>(received) : 0;
+    int waiting = 0;
+    ioctl(m_master, FIONREAD, &waiting);
+    return {
+      .data = p_data.first(length),
+      .available = static_cast<std::size_t>(std::max(waiting, 0)),
+      .capacity = receive_capacity,
+    };
+  }
+
+  void driver_flush() override
+  {
+    tcflush(m_master, TCIFLUSH);
+  }
+
+  int m_master = -1;
+  int m_slave = -1;
+};
+
+/**
+ * @brief Output pin feeding the simulated multiplexer
+ *
+ */
+class host_output_pin : public hal::output_pin
+{
+public:
+  host_output_pin(bool* p_level)
+    : m_level(p_level)
+  {
+  }
+
+private:
+  void driver_configure(settings const&) override
+  {
+  }
+
+  void driver_level(bool p_high) override
+  {
+    std::lock_guard guard(world.lock());
+    if (*m_level != p_high) {
+      world.begin_settle();
+    }
+    if (m_level == &world.counter_reset && p_high) {
+      world.falling_edges = 0;
+    }
+    if (m_level == &world.counter_clock && *m_level && not p_high &&
+        not world.counter_reset) {
+      world.falling_edges++;
+    }
+    *m_level = p_high;
+  }
+
+  bool driver_level() override
+  {
+    std::lock_guard guard(world.lock());
+    return *m_level;
+  }
+
+  bool* m_level;
+};
+
+class intensity_adc : public hal::adc
+{
+private:
+  float driver_read() override
+  {
+    std::lock_guard guard(world.lock());
+    world.update();
+    return world.intensity();
+  }
+};
+
+class reference_adc : public hal::adc
+{
+private:
+  float driver_read() override
+  {
+    return reference_reading;
+  }
+};
+
+/**
+ * @brief Timer running its callback on a thread
+ *
+ * Stands in for the timer interrupt. The callback may reschedule the timer.
+ */
+class host_timer : public hal::timer
+{
+public:
+  host_timer()
+    : m_thread([this]() { run(); })
+  {
+    m_thread.detach();
+  }
+
+private:
+  bool driver_is_running() override
+  {
+    std::lock_guard guard(m_mutex);
+    return m_pending;
+  }
+
+  void driver_cancel() override
+  {
+    std::lock_guard guard(m_mutex);
+    m_pending = false;
+  }
+
+  void driver_schedule(hal::callback<void(void)> p_callback,
+                       hal::time_duration p_delay) override
+  {
+    {
+      std::lock_guard guard(m_mutex);
+      m_callback = p_callback;
+      m_deadline = std::chrono::steady_clock::now() + p_delay;
+      m_pending = true;
+    }
+    m_wake.notify_one();
+  }
+
+  [[noreturn]] void run()
+  {
+    std::unique_lock guard(m_mutex);
+    while (true) {
+      if (not m_pending) {
+        m_wake.wait(guard);
+        continue;
+      }
+      if (m_wake.wait_until(guard, m_deadline) != std::cv_status::timeout) {
+        // Rescheduled or cancelled
+        continue;
+      }
+      if (not m_pending || std::chrono::steady_clock::now() < m_deadline) {
+        continue;
+      }
+      m_pending = false;
+      auto callback = m_callback;
+      guard.unlock();
+      callback();
+      guard.lock();
+    }
+  }
+
+  std::mutex m_mutex;
+  std::condition_variable m_wake;
+  hal::callback<void(void)> m_callback{};
+  std::chrono::steady_clock::time_point m_deadline{};
+  bool m_pending = false;
+  std::thread m_thread;
+};
+
+hal::v5::optional_ptr<pty_serial> console_ptr;
+hal::v5::optional_ptr<pty_serial> rs485_ptr;
+hal::v5::optional_ptr<host_clock> clock_ptr;
+bool transceiver_level = false;
+}  // namespace
+
+std::pmr::polymorphic_allocator<> driver_allocator()
+{
+  return std::pmr::new_delete_resource();
+}
+
+hal::v5::strong_ptr<hal::steady_clock> clock()
+{
+  if (not clock_ptr) {
+    clock_ptr = hal::v5::make_strong_ptr<host_clock>(driver_allocator());
+  }
+  return clock_ptr;
+}
+
+hal::v5::strong_ptr<hal::serial> console()
+{
+  if (not console_ptr) {
+    console_ptr =
+      hal::v5::make_strong_ptr<pty_serial>(driver_allocator(), "console");
+  }
+  return console_ptr;
+}
+
+hal::v5::strong_ptr<hal::serial> rs485_transceiver()
+{
+  if (not rs485_ptr) {
+    rs485_ptr =
+      hal::v5::make_strong_ptr<pty_serial>(driver_allocator(), "rs485");
+  }
+  return rs485_ptr;
+}
+
+hal::v5::strong_ptr<hal::adc> intensity()
+{
+  return hal::v5::make_strong_ptr<intensity_adc>(driver_allocator());
+}
+
+/**
+ * @brief I2C bus with the simulated camera on it
+ *
+ */
+class host_i2c : public hal::i2c
+{
+private:
+  void driver_configure(settings const&) override
+  {
+  }
+
+  void driver_transaction(
+    hal::byte p_address,
+    std::span<hal::byte const> p_data_out,
+    std::span<hal::byte> p_data_in,
+    hal::function_ref<hal::timeout_function> p_timeout) override
+  {
+    std::lock_guard guard(world.lock());
+    world.update();
+    world.camera.transaction(p_address, p_data_out, p_data_in, p_timeout);
+  }
+};
+
+hal::v5::strong_ptr<hal::adc> adc_reference()
+{
+  return hal::v5::make_strong_ptr<reference_adc>(driver_allocator());
+}
+
+hal::v5::strong_ptr<hal::i2c> i2c()
+{
+  return hal::v5::make_strong_ptr<host_i2c>(driver_allocator());
+}
+
+hal::v5::strong_ptr<hal::output_pin> counter_reset()
+{
+  return hal::v5::make_strong_ptr<host_output_pin>(driver_allocator(),
+                                                   &world.counter_reset);
+}
+
+hal::v5::strong_ptr<hal::output_pin> counter_clock()
+{
+  return hal::v5::make_strong_ptr<host_output_pin>(driver_allocator(),
+                                                   &world.counter_clock);
+}
+
+hal::v5::strong_ptr<hal::output_pin> frequency_select()
+{
+  return hal::v5::make_strong_ptr<host_output_pin>(driver_allocator(),
+                                                   &world.high_frequency);
+}
+
+hal::v5::strong_ptr<hal::output_pin> transceiver_direction()
+{
+  return hal::v5::make_strong_ptr<host_output_pin>(driver_allocator(),
+                                                   &transceiver_level);
+}
+
+hal::v5::strong_ptr<hal::timer> sequencer_timer()
+{
+  return hal::v5::make_strong_ptr<host_timer>(driver_allocator());
+}
+
+void wait_for_work()
+{
+  // Wake on received bytes or after 1 ms, the main loop's timed work (camera
+  // polls, snapshots) is checked at least that often.
+  std::array<pollfd, 2> ports{};
+  std::size_t count = 0;
+  for (auto const& port : { console_ptr, rs485_ptr }) {
+    if (port) {
+      ports[count++] = { .fd = port->fd(), .events = POLLIN, .revents = 0 };
+    }
+  }
+  poll(ports.data(), count, 1);
+}
+
+void reset()
+{
+  std::fprintf(stderr, "host: reset requested, exiting\n");
+  std::exit(EXIT_SUCCESS);
+}
+}  // namespace resources
+
+void initialize_platform()
+{
+  if (auto const* const script = std::getenv("E10_HOST_SCRIPT")) {
+    resources::world.load(script);
+  }
+}
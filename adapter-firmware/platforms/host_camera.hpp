@@ -0,0 +1,185 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <deque>
+#include <numeric>
+#include <span>
+#include <vector>
+
+#include <libhal/error.hpp>
+#include <libhal/i2c.hpp>
+#include <libhal/units.hpp>
+
+namespace e10::host {
+/**
+ * @brief An object the simulated camera reports
+ *
+ */
+struct camera_object
+{
+  /// Response command, 0x1C for a block or 0x1D for an arrow
+  hal::byte command = 0;
+  hal::byte id = 0;
+  /// x, y, width, height of a block or the two end points of an arrow
+  std::array<hal::u16, 4> geometry{};
+};
+
+/**
+ * @brief Camera on the I2C bus answering the firmware's camera protocol
+ *
+ * Requests are `0x55 0xAA command algorithm length payload checksum`. A knock
+ * (0x00) and an algorithm change (0x0A) are answered with OK, a block request
+ * (0x01) with an info response holding the object count followed by one
+ * response per object. Reads with nothing left to send return 0xFF like an
+ * idle camera. An unplugged camera does not acknowledge its address.
+ *
+ * Not thread safe, the owner serialises every access.
+ */
+class simulated_camera : public hal::i2c
+{
+public:
+  /// Camera's I2C address
+  static constexpr hal::byte address = 0x50;
+
+  /**
+   * @brief Connect or disconnect the camera
+   *
+   * Unplugging loses whatever the camera had left to send.
+   *
+   * @param p_plugged - the camera answers on the bus
+   */
+  void plug(bool p_plugged)
+  {
+    m_plugged = p_plugged;
+    if (not p_plugged) {
+      m_output.clear();
+    }
+  }
+
+  /// Report another object in every following result
+  void add_object(camera_object const& p_object)
+  {
+    m_objects.push_back(p_object);
+  }
+
+  /// Report no objects
+  void clear_objects()
+  {
+    m_objects.clear();
+  }
+
+  /// Send junk bytes before the next response
+  void add_garbage(hal::u32 p_count)
+  {
+    m_garbage += p_count;
+  }
+
+  /// Algorithm the camera was last switched to
+  hal::byte algorithm() const
+  {
+    return m_algorithm;
+  }
+
+  /// Number of requests received, including the ones not understood
+  hal::u32 requests() const
+  {
+    return m_requests;
+  }
+
+private:
+  void driver_configure(settings const&) override
+  {
+  }
+
+  void driver_transaction(
+    hal::byte p_address,
+    std::span<hal::byte const> p_data_out,
+    std::span<hal::byte> p_data_in,
+    hal::function_ref<hal::timeout_function>) override
+  {
+    if (p_address != address || not m_plugged) {
+      hal::safe_throw(hal::no_such_device(p_address, this));
+    }
+    if (not p_data_out.empty()) {
+      request(p_data_out);
+    }
+    for (auto& byte : p_data_in) {
+      if (m_output.empty()) {
+        byte = 0xFF;
+        continue;
+      }
+      byte = m_output.front();
+      m_output.pop_front();
+    }
+  }
+
+  void request(std::span<hal::byte const> p_data)
+  {
+    m_requests++;
+    if (p_data.size() < 5 || p_data[0] != 0x55 || p_data[1] != 0xAA) {
+      return;
+    }
+    auto const command = p_data[2];
+    switch (command) {
+      case 0x00:  // Knock
+        respond(0x00, { 0x00 });
+        break;
+      case 0x0A:  // Change algorithm
+        m_algorithm = p_data[3];
+        respond(0x0A, { 0x00 });
+        break;
+      case 0x01: {  // Request blocks
+        respond(0x1B, { static_cast<hal::byte>(m_objects.size()) });
+        for (auto const& object : m_objects) {
+          std::vector<hal::byte> payload{ object.id, 0x00 };
+          for (auto const value : object.geometry) {
+            payload.push_back(static_cast<hal::byte>(value & 0xFF));
+            payload.push_back(static_cast<hal::byte>(value >> 8));
+          }
+          respond(object.command, payload);
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  void respond(hal::byte p_command, std::vector<hal::byte> const& p_payload)
+  {
+    for (; m_garbage > 0; m_garbage--) {
+      m_output.push_back(0x42);
+    }
+    std::vector<hal::byte> response{ 0x55,
+                                     0xAA,
+                                     p_command,
+                                     m_algorithm,
+                                     static_cast<hal::byte>(p_payload.size()) };
+    response.insert(response.end(), p_payload.begin(), p_payload.end());
+    response.push_back(
+      std::accumulate(response.begin(), response.end(), hal::byte{ 0 }));
+    m_output.insert(m_output.end(), response.begin(), response.end());
+  }
+
+  std::vector<camera_object> m_objects{};
+  std::deque<hal::byte> m_output{};
+  hal::u32 m_garbage = 0;
+  hal::u32 m_requests = 0;
+  hal::byte m_algorithm = 0;
+  bool m_plugged = true;
+};
+}  // namespace e10::host
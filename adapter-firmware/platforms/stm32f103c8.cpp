@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cstdint>
+
 #include <libhal-arm-mcu/dwt_counter.hpp>
 #include <libhal-arm-mcu/startup.hpp>
 #include <libhal-arm-mcu/stm32f1/adc.hpp>
@@ -27,6 +30,7 @@
 #include <libhal-arm-mcu/stm32f1/uart.hpp>
 #include <libhal-arm-mcu/stm32f1/usart.hpp>
 #include <libhal-arm-mcu/system_control.hpp>
+#include <libhal-arm-mcu/systick_timer.hpp>
 #include <libhal-exceptions/control.hpp>
 #include <libhal-util/atomic_spin_lock.hpp>
 #include <libhal-util/bit_bang_i2c.hpp>
@@ -99,16 +103,158 @@ hal::v5::strong_ptr<hal::steady_clock> clock()
   return clock_ptr;
 }
 
+// USART register blocks and the offsets of the registers used next to the
+// libhal UART driver
+constexpr std::uintptr_t usart1_base = 0x4001'3800;
+constexpr std::uintptr_t usart2_base = 0x4000'4400;
+constexpr std::uintptr_t usart_sr = 0x00;
+constexpr std::uintptr_t usart_cr1 = 0x0C;
+
+hal::u32 volatile* usart_register(std::uintptr_t p_base,
+                                  std::uintptr_t p_offset)
+{
+  return reinterpret_cast<hal::u32 volatile*>(p_base + p_offset);
+}
+
+/**
+ * @brief UART 1 that only takes the bytes its transmitter has room for
+ *
+ * The UART driver waits for the data register to empty before every byte.
+ * The console is drained by e10::deferred_serial from the main loop, which
+ * must not wait on it, so bytes are only handed to the driver while the
+ * transmit data register is empty. A write returns the bytes taken, the rest
+ * stays buffered for the next drain.
+ */
+class console_uart : public hal::serial
+{
+public:
+  console_uart(hal::v5::strong_ptr<hal::serial> p_uart)
+    : m_uart(std::move(p_uart))
+  {
+  }
+
+private:
+  /// Transmit data register empty (TXE) flag of the status register
+  static constexpr hal::u32 transmit_empty = 1U << 7;
+
+  void driver_configure(settings const& p_settings) override
+  {
+    m_uart->configure(p_settings);
+  }
+
+  write_t driver_write(std::span<hal::byte const> p_data) override
+  {
+    auto* const usart1_sr = usart_register(usart1_base, usart_sr);
+
+    std::size_t taken = 0;
+    while (taken < p_data.size() && (*usart1_sr & transmit_empty) != 0) {
+      m_uart->write(p_data.subspan(taken, 1));
+      taken++;
+    }
+    return { .data = p_data.first(taken) };
+  }
+
+  read_t driver_read(std::span<hal::byte> p_data) override
+  {
+    return m_uart->read(p_data);
+  }
+
+  void driver_flush() override
+  {
+    m_uart->flush();
+  }
+
+  hal::v5::strong_ptr<hal::serial> m_uart;
+};
+
 hal::v5::strong_ptr<hal::serial> console()
 {
-  return hal::v5::make_strong_ptr<hal::stm32f1::uart>(
+  auto uart = hal::v5::make_strong_ptr<hal::stm32f1::uart>(
     driver_allocator(), hal::port<1>, hal::buffer<128>);
+  return hal::v5::make_strong_ptr<console_uart>(driver_allocator(), uart);
 }
 
+/**
+ * @brief UART 2 with the RS485 transceiver's direction under its control
+ *
+ * The UART driver returns once the last byte is handed to the data register,
+ * which is still one byte time before it is on the bus. The direction is only
+ * released once the USART's transmission complete flag is set. The wait is
+ * bounded by the time the written bytes take on the bus plus a margin. A
+ * transmitter that never finishes releases the bus and throws
+ * hal::timed_out.
+ */
+class rs485_uart : public hal::serial
+{
+public:
+  rs485_uart(hal::v5::strong_ptr<hal::serial> p_uart,
+             hal::v5::strong_ptr<hal::output_pin> p_direction,
+             hal::v5::strong_ptr<hal::steady_clock> p_clock)
+    : m_uart(std::move(p_uart))
+    , m_direction(std::move(p_direction))
+    , m_clock(std::move(p_clock))
+  {
+    m_direction->level(false);
+  }
+
+private:
+  /// Bits on the bus per byte: start, 8 data and stop bit
+  static constexpr float bits_per_byte = 10.0f;
+  /// Byte times allowed on top of the written bytes before giving up
+  static constexpr float margin_bytes = 2.0f;
+  /// Transmission complete (TC) flag of the status register
+  static constexpr hal::u32 transmission_complete = 1U << 6;
+
+  void driver_configure(settings const& p_settings) override
+  {
+    m_uart->configure(p_settings);
+    m_baud_rate = p_settings.baud_rate;
+  }
+
+  write_t driver_write(std::span<hal::byte const> p_data) override
+  {
+    auto* const usart2_sr = usart_register(usart2_base, usart_sr);
+
+    m_direction->level(true);
+    auto const result = m_uart->write(p_data);
+
+    auto const bytes = static_cast<float>(p_data.size()) + margin_bytes;
+    auto const seconds =
+      bytes * bits_per_byte / static_cast<float>(m_baud_rate);
+    auto const timeout = static_cast<hal::u64>(seconds * m_clock->frequency());
+    auto const deadline = m_clock->uptime() + timeout;
+    while ((*usart2_sr & transmission_complete) == 0) {
+      if (m_clock->uptime() > deadline) {
+        m_direction->level(false);
+        hal::safe_throw(hal::timed_out(this));
+      }
+    }
+    m_direction->level(false);
+    return result;
+  }
+
+  read_t driver_read(std::span<hal::byte> p_data) override
+  {
+    return m_uart->read(p_data);
+  }
+
+  void driver_flush() override
+  {
+    m_uart->flush();
+  }
+
+  hal::v5::strong_ptr<hal::serial> m_uart;
+  hal::v5::strong_ptr<hal::output_pin> m_direction;
+  hal::v5::strong_ptr<hal::steady_clock> m_clock;
+  hal::u32 m_baud_rate = settings{}.baud_rate;
+};
+
 hal::v5::strong_ptr<hal::serial> rs485_transceiver()
 {
-  return hal::v5::make_strong_ptr<hal::stm32f1::uart>(
+  auto uart = hal::v5::make_strong_ptr<hal::stm32f1::uart>(
     driver_allocator(), hal::port<2>, hal::buffer<128>);
+  return hal::v5::make_strong_ptr<rs485_uart>(
+    driver_allocator(), uart, transceiver_direction(), clock());
 }
 
 auto& adc1()
@@ -130,8 +276,199 @@ hal::v5::strong_ptr<hal::adc> adc_reference()
     driver_allocator(), adc1(), hal::stm32f1::adc_pins::pb1);
 }
 
+/**
+ * @brief I2C1 peripheral on PB6 (SCL) and PB7 (SDA)
+ *
+ * Polled rather than interrupt or DMA driven: the camera code waits for every
+ * transaction anyway, and the hardware already removes the per bit work of
+ * the bit banged bus. Reads follow the STM32F1 errata sequences for 1, 2 and
+ * more bytes so the last byte is never followed by an unwanted ACK.
+ */
+class i2c1_peripheral : public hal::i2c
+{
+public:
+  i2c1_peripheral(settings const& p_settings)
+  {
+    // RCC: clock GPIOB and AFIO on APB2 and I2C1 on APB1
+    auto* const rcc_apb2enr = reinterpret_cast<hal::u32 volatile*>(0x4002'1018);
+    auto* const rcc_apb1enr = reinterpret_cast<hal::u32 volatile*>(0x4002'101C);
+    *rcc_apb2enr = *rcc_apb2enr | (1U << 3) | (1U << 0);
+    *rcc_apb1enr = *rcc_apb1enr | (1U << 21);
+
+    // PB6 and PB7 as 50MHz alternate function open drain outputs
+    auto* const gpiob_crl = reinterpret_cast<hal::u32 volatile*>(0x4001'0C00);
+    *gpiob_crl = (*gpiob_crl & ~0xFF00'0000U) | 0xFF00'0000U;
+
+    driver_configure(p_settings);
+  }
+
+private:
+  struct registers
+  {
+    hal::u32 volatile cr1;
+    hal::u32 volatile cr2;
+    hal::u32 volatile oar1;
+    hal::u32 volatile oar2;
+    hal::u32 volatile dr;
+    hal::u32 volatile sr1;
+    hal::u32 volatile sr2;
+    hal::u32 volatile ccr;
+    hal::u32 volatile trise;
+  };
+
+  // CR1 bits
+  static constexpr hal::u32 enable = 1U << 0;
+  static constexpr hal::u32 start = 1U << 8;
+  static constexpr hal::u32 stop = 1U << 9;
+  static constexpr hal::u32 ack = 1U << 10;
+  static constexpr hal::u32 position = 1U << 11;
+  static constexpr hal::u32 software_reset = 1U << 15;
+  // SR1 bits
+  static constexpr hal::u32 start_bit = 1U << 0;
+  static constexpr hal::u32 address_sent = 1U << 1;
+  static constexpr hal::u32 byte_finished = 1U << 2;
+  static constexpr hal::u32 receive_not_empty = 1U << 6;
+  static constexpr hal::u32 transmit_empty = 1U << 7;
+  static constexpr hal::u32 bus_error = 1U << 8;
+  static constexpr hal::u32 arbitration_lost = 1U << 9;
+  static constexpr hal::u32 ack_failure = 1U << 10;
+
+  static registers& reg()
+  {
+    return *reinterpret_cast<registers*>(0x4000'5400);
+  }
+
+  void driver_configure(settings const& p_settings) override
+  {
+    auto const pclk = hal::stm32f1::frequency(st_peripheral::i2c1);
+    auto const pclk_mhz = static_cast<hal::u32>(pclk / 1'000'000.0f);
+
+    reg().cr1 = software_reset;
+    reg().cr1 = 0;
+    reg().cr2 = pclk_mhz;
+    if (p_settings.clock_rate <= 100'000.0f) {
+      // Standard mode, SCL high and low for CCR clocks each
+      auto const ccr =
+        static_cast<hal::u32>(pclk / (2 * p_settings.clock_rate));
+      reg().ccr = std::max(ccr, 4U);
+      reg().trise = pclk_mhz + 1;
+    } else {
+      // Fast mode with a 1:2 duty cycle, 300ns max rise time
+      auto const ccr =
+        static_cast<hal::u32>(pclk / (3 * p_settings.clock_rate));
+      reg().ccr = (1U << 15) | std::max(ccr, 1U);
+      reg().trise = (pclk_mhz * 300 / 1000) + 1;
+    }
+    reg().cr1 = enable;
+  }
+
+  void driver_transaction(
+    hal::byte p_address,
+    std::span<hal::byte const> p_data_out,
+    std::span<hal::byte> p_data_in,
+    hal::function_ref<hal::timeout_function> p_timeout) override
+  {
+    if (not p_data_out.empty()) {
+      begin(p_address << 1, p_timeout);
+      clear_address();
+      for (auto const byte : p_data_out) {
+        wait_for(transmit_empty, p_timeout);
+        reg().dr = byte;
+      }
+      wait_for(byte_finished, p_timeout);
+    }
+
+    if (p_data_in.empty()) {
+      finish();
+      return;
+    }
+
+    begin((p_address << 1) | 1, p_timeout);
+    auto const length = p_data_in.size();
+    if (length == 1) {
+      reg().cr1 = reg().cr1 & ~ack;
+      clear_address();
+      finish();
+      wait_for(receive_not_empty, p_timeout);
+      p_data_in[0] = reg().dr;
+    } else if (length == 2) {
+      // NACK the byte after the one in the shift register
+      reg().cr1 = reg().cr1 | ack | position;
+      clear_address();
+      reg().cr1 = reg().cr1 & ~ack;
+      wait_for(byte_finished, p_timeout);
+      finish();
+      p_data_in[0] = reg().dr;
+      p_data_in[1] = reg().dr;
+      reg().cr1 = reg().cr1 & ~position;
+    } else {
+      reg().cr1 = reg().cr1 | ack;
+      clear_address();
+      for (std::size_t i = 0; i < length - 3; i++) {
+        wait_for(receive_not_empty, p_timeout);
+        p_data_in[i] = reg().dr;
+      }
+      // Byte N-2 is in DR and N-1 in the shift register, NACK byte N
+      wait_for(byte_finished, p_timeout);
+      reg().cr1 = reg().cr1 & ~ack;
+      p_data_in[length - 3] = reg().dr;
+      wait_for(byte_finished, p_timeout);
+      finish();
+      p_data_in[length - 2] = reg().dr;
+      wait_for(receive_not_empty, p_timeout);
+      p_data_in[length - 1] = reg().dr;
+    }
+  }
+
+  void begin(hal::byte p_address_byte,
+             hal::function_ref<hal::timeout_function> p_timeout)
+  {
+    // The previous stop condition must be on the bus before the next start
+    while (reg().cr1 & stop) {
+      p_timeout();
+    }
+    reg().cr1 = reg().cr1 | start;
+    wait_for(start_bit, p_timeout);
+    reg().dr = p_address_byte;
+    try {
+      wait_for(address_sent, p_timeout);
+    } catch (hal::io_error const&) {
+      hal::safe_throw(hal::no_such_device(p_address_byte >> 1, this));
+    }
+  }
+
+  void clear_address()
+  {
+    // ADDR is cleared by reading SR1 followed by SR2
+    [[maybe_unused]] auto const sr1 = reg().sr1;
+    [[maybe_unused]] auto const sr2 = reg().sr2;
+  }
+
+  void finish()
+  {
+    reg().cr1 = reg().cr1 | stop;
+  }
+
+  void wait_for(hal::u32 p_flag,
+                hal::function_ref<hal::timeout_function> p_timeout)
+  {
+    while ((reg().sr1 & p_flag) == 0) {
+      if (reg().sr1 & (bus_error | arbitration_lost | ack_failure)) {
+        reg().sr1 = 0;
+        finish();
+        hal::safe_throw(hal::io_error(this));
+      }
+      p_timeout();
+    }
+  }
+};
+
 hal::v5::strong_ptr<hal::i2c> i2c()
 {
+#if E10_HARDWARE_I2C
+  return hal::v5::make_strong_ptr<i2c1_peripheral>(
+    driver_allocator(), hal::i2c::settings{ .clock_rate = 400.0_kHz });
+#else
   static auto sda_output_pin =
     hal::acquire_output_pin(driver_allocator(), gpio_b(), 7);
   static auto scl_output_pin =
@@ -144,6 +481,7 @@ hal::v5::strong_ptr<hal::i2c> i2c()
       .scl = &(*scl_output_pin),
     },
     *clock);
+#endif
 }
 
 hal::v5::strong_ptr<hal::output_pin> counter_reset()
@@ -166,6 +504,50 @@ hal::v5::strong_ptr<hal::output_pin> transceiver_direction()
   return hal::acquire_output_pin(driver_allocator(), gpio_a(), 0);
 }
 
+hal::v5::strong_ptr<hal::timer> sequencer_timer()
+{
+  // SysTick is otherwise unused as the uptime clock is the DWT counter
+  auto cpu_frequency = hal::stm32f1::frequency(hal::stm32f1::peripheral::cpu);
+  return hal::v5::make_strong_ptr<hal::cortex_m::systick_timer>(
+    driver_allocator(), cpu_frequency);
+}
+
+void wait_for_work()
+{
+  // Cortex-M3 system control and interrupt controller registers
+  auto* const scb_scr = reinterpret_cast<hal::u32 volatile*>(0xE000'ED10);
+  auto* const nvic_icpr1 = reinterpret_cast<hal::u32 volatile*>(0xE000'E284);
+  // STM32F1 debug unit and USART control registers
+  auto* const dbgmcu_cr = reinterpret_cast<hal::u32 volatile*>(0xE004'2004);
+  auto* const usart1_cr1 = usart_register(usart1_base, usart_cr1);
+  auto* const usart2_cr1 = usart_register(usart2_base, usart_cr1);
+  // USART1 and USART2 are interrupts 37 and 38
+  constexpr hal::u32 usart_lines = (1U << (37 - 32)) | (1U << (38 - 32));
+
+  static bool configured = false;
+  if (not configured) {
+    // DBG_SLEEP: keep the core clocked while asleep, otherwise the DWT counter
+    // behind resources::clock() stops counting.
+    *dbgmcu_cr = *dbgmcu_cr | (1U << 0);
+    // SEVONPEND: interrupts disabled in the NVIC still wake WFE when they
+    // become pending.
+    *scb_scr = *scb_scr | (1U << 4);
+    // RXNEIE: received bytes raise the USART interrupt lines. The lines stay
+    // disabled in the NVIC so no handler runs, the data itself is still moved
+    // by the UART driver.
+    *usart1_cr1 = *usart1_cr1 | (1U << 5);
+    *usart2_cr1 = *usart2_cr1 | (1U << 5);
+    configured = true;
+  }
+
+  // Bytes received since the last call have already set the event register,
+  // so WFE returns straight away instead of missing them.
+  asm volatile("wfe");
+  // Only the transition to pending is an event, clear the lines so the next
+  // byte is one too.
+  *nvic_icpr1 = usart_lines;
+}
+
 // Watchdog implementation using global function pattern from original
 class stm32f103c8_watchdog : public custom::watchdog
 {
@@ -0,0 +1,88 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <numeric>
+
+#include <bearing.hpp>
+
+namespace e10 {
+bearing interpolate_bearing(
+  std::array<hal::u16, diode_count> const& p_intensity)
+{
+  constexpr float full_confidence_level = 65535.0f / 4.0f;
+  constexpr auto last = static_cast<std::ptrdiff_t>(diode_count - 1);
+
+  auto const strongest = std::ranges::max_element(p_intensity);
+  auto const peak = std::distance(p_intensity.begin(), strongest);
+  auto const at = [&p_intensity](std::ptrdiff_t p_index) {
+    return static_cast<float>(p_intensity[p_index]);
+  };
+
+  bearing result{};
+  result.peak = static_cast<hal::u8>(peak);
+
+  auto const peak_value = at(peak);
+  if (peak_value <= 0.0f) {
+    return result;
+  }
+
+  // max_element() found the first of any equally strong diodes
+  auto plateau_end = peak;
+  while (plateau_end < last && at(plateau_end + 1) == peak_value) {
+    plateau_end++;
+  }
+
+  float offset = 0.0f;
+  if (plateau_end > peak) {
+    // A flat top has no vertex, use the middle of the plateau
+    offset = static_cast<float>(plateau_end - peak) / 2.0f;
+  } else if (peak == 0 || peak == last) {
+    // Only one neighbour, use the centroid of the peak and that neighbour
+    auto const neighbour = (peak == 0) ? 1 : last - 1;
+    auto const direction = (peak == 0) ? 1.0f : -1.0f;
+    offset = direction * at(neighbour) / (peak_value + at(neighbour));
+  } else {
+    // Vertex of the parabola through the peak and its neighbours
+    auto const left = at(peak - 1);
+    auto const right = at(peak + 1);
+    auto const curvature = left - 2.0f * peak_value + right;
+    if (curvature < 0.0f) {
+      offset = std::clamp(0.5f * (left - right) / curvature, -0.5f, 0.5f);
+    }
+  }
+
+  auto const position =
+    (static_cast<float>(peak) + offset) * bearing::steps_per_diode;
+  result.position = static_cast<hal::u16>(
+    std::clamp(std::lround(position),
+               0L,
+               static_cast<long>(last * bearing::steps_per_diode)));
+
+  auto const total = std::accumulate(
+    p_intensity.begin(), p_intensity.end(), 0.0f, [](float p_sum, auto p_v) {
+      return p_sum + static_cast<float>(p_v);
+    });
+  auto const others_mean =
+    (total - peak_value) / static_cast<float>(diode_count - 1);
+  auto const prominence = (peak_value - others_mean) / peak_value;
+  auto const strength = std::min(1.0f, peak_value / full_confidence_level);
+  result.confidence =
+    static_cast<hal::u8>(std::lround(255.0f * prominence * strength));
+
+  return result;
+}
+}  // namespace e10
@@ -0,0 +1,126 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <camera_service.hpp>
+#include <huskylens.hpp>
+#include <log.hpp>
+
+namespace e10 {
+camera_service::camera_service(resources_t p_resources)
+  : m_resources(p_resources)
+{
+}
+
+bool camera_service::step()
+{
+  auto& connection = m_resources.connection;
+  if (connection.next_step() != camera_connection::step::none) {
+    advance();
+    return true;
+  }
+  if (connection.ready() && m_resources.poller.due()) {
+    poll();
+    return true;
+  }
+  return false;
+}
+
+std::optional<camera_frame> camera_service::read()
+{
+  try {
+    return huskylens::get_camera_data(m_resources.buffer,
+                                      m_resources.link,
+                                      m_resources.console,
+                                      m_resources.poller.algorithm());
+  } catch (...) {
+    lost();
+  }
+  return std::nullopt;
+}
+
+void camera_service::poll()
+{
+  // A failed read already emptied the cache, storing would mark it fresh
+  if (auto const frame = read()) {
+    m_resources.poller.store(*frame);
+  }
+}
+
+void camera_service::advance()
+{
+  using step = camera_connection::step;
+  auto& console = m_resources.console;
+  auto& connection = m_resources.connection;
+  auto& camera = m_resources.poller;
+
+  if (connection.next_step() == step::send_algorithm) {
+    try {
+      m_algorithm_sent = camera.algorithm();
+      huskylens::send_algorithm_change(m_resources.link, m_algorithm_sent);
+      connection.algorithm_sent();
+    } catch (...) {
+      lost();
+    }
+    return;
+  }
+
+  if (connection.next_step() == step::read_algorithm) {
+    auto const sent = m_algorithm_sent;
+    try {
+      auto const accepted = huskylens::algorithm_accepted(
+        m_resources.buffer, m_resources.link, console, sent);
+      connection.algorithm_answered();
+      // Fall back to any algorithm, unless another one was selected since
+      if (not accepted && camera.algorithm() == sent) {
+        camera.select(huskylens::any_algo);
+        connection.cancel_algorithm_change();
+      }
+    } catch (...) {
+      lost();
+    }
+    return;
+  }
+
+  bool accepted = false;
+  try {
+    if (connection.next_step() == step::send_knock) {
+      e10::log<log_level::info>(console, "Reconnecting Camera\n");
+      huskylens::send_knock(m_resources.link, console);
+      connection.knock_sent();
+      return;
+    }
+    accepted =
+      huskylens::knock_accepted(m_resources.buffer, m_resources.link, console);
+  } catch (...) {
+    e10::log<log_level::debug>(console, "Camera not answering\n");
+  }
+
+  connection.knock_answered(accepted);
+  if (accepted) {
+    e10::log<log_level::info>(console, "Camera connected\n");
+    // A camera that was power cycled is back on its default algorithm
+    if (camera.algorithm() != huskylens::any_algo) {
+      connection.change_algorithm();
+    }
+  }
+}
+
+void camera_service::lost()
+{
+  m_resources.connection.lost();
+  m_resources.poller.invalidate();
+  e10::log<log_level::warning>(m_resources.console,
+                               "Camera not connected...\n");
+}
+}  // namespace e10
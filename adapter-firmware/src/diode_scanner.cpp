@@ -0,0 +1,358 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include <libhal-util/map.hpp>
+#include <libhal/error.hpp>
+
+#include <diode_scanner.hpp>
+#include <profile.hpp>
+
+namespace e10 {
+namespace {
+constexpr auto index(irb_freq p_frequency)
+{
+  return static_cast<std::size_t>(p_frequency);
+}
+}  // namespace
+
+diode_scanner::diode_scanner(resources_t p_resources)
+  : m_resources(p_resources)
+  , m_reference_tracker(p_resources.reference, p_resources.clock)
+{
+  m_resources.counter_reset.level(true);
+  m_resources.counter_clock.level(true);
+}
+
+void diode_scanner::start()
+{
+  on_timer();
+}
+
+void diode_scanner::on_timer()
+{
+  using namespace std::chrono_literals;
+  hal::time_duration delay{};
+  {
+    profile_scope const profile(profile_zone::diode_step);
+    // Run back to back steps together, they do not need to wait on anything
+    delay = step();
+    while (delay == 0us) {
+      delay = step();
+    }
+  }
+  m_resources.timer.schedule([this]() { on_timer(); }, delay);
+}
+
+diode_sweep diode_scanner::latest(irb_freq p_frequency) const
+{
+  return m_results[index(p_frequency)].read();
+}
+
+hal::u32 diode_scanner::sweeps_completed(irb_freq p_frequency) const
+{
+  return m_results[index(p_frequency)].generation();
+}
+
+void diode_scanner::set_timing(diode_timing const& p_timing)
+{
+  auto const in_range = [](hal::time_duration p_time) {
+    return min_phase_time <= p_time && p_time <= max_phase_time;
+  };
+
+  if (not in_range(p_timing.integration) || not in_range(p_timing.settle) ||
+      not in_range(p_timing.frequency_settle)) {
+    hal::safe_throw(hal::argument_out_of_domain(this));
+  }
+
+  m_requested_timing.back() = p_timing;
+  m_requested_timing.publish();
+}
+
+diode_timing diode_scanner::timing() const
+{
+  return m_active_timing.read();
+}
+
+void diode_scanner::calibrate()
+{
+  m_calibrate_requested = true;
+}
+
+bool diode_scanner::calibrating() const
+{
+  return m_calibrate_requested || m_calibrating;
+}
+
+void diode_scanner::set_mode(sweep_mode p_mode)
+{
+  m_requested_mode = p_mode;
+}
+
+sweep_mode diode_scanner::mode() const
+{
+  return m_requested_mode;
+}
+
+void diode_scanner::set_oversampling(oversampling p_oversampling)
+{
+  if (p_oversampling.count == 0 ||
+      p_oversampling.count > oversampling::max_count) {
+    hal::safe_throw(hal::argument_out_of_domain(this));
+  }
+  m_requested_oversampling = p_oversampling;
+}
+
+oversampling diode_scanner::current_oversampling() const
+{
+  return m_requested_oversampling;
+}
+
+float diode_scanner::reference() const
+{
+  return m_reference_tracker.value();
+}
+
+hal::time_duration diode_scanner::trace_intensity(
+  hal::time_duration p_window,
+  hal::time_duration& p_worst_case)
+{
+  using namespace std::chrono_literals;
+
+  if (m_trace_length < m_trace.size()) {
+    m_trace[m_trace_length++] = m_resources.intensity.read();
+  }
+  m_trace_elapsed += calibration_interval;
+
+  if (m_trace_elapsed < p_window) {
+    return calibration_interval;
+  }
+
+  // Find the first reading after which every reading stays within the
+  // tolerance band around the final reading.
+  auto const final_reading = m_trace[m_trace_length - 1];
+  auto const band = calibration_tolerance * m_reference;
+  std::size_t settled_index = 0;
+  for (std::size_t i = 0; i < m_trace_length; i++) {
+    if (std::abs(m_trace[i] - final_reading) > band) {
+      settled_index = i + 1;
+    }
+  }
+
+  // Reading N was taken N + 1 intervals after the clock edge
+  auto const converged =
+    calibration_interval * static_cast<int>(settled_index + 1);
+  p_worst_case = std::max(p_worst_case, converged);
+  return 0us;
+}
+
+void diode_scanner::finish_calibration()
+{
+  constexpr diode_timing ceiling{};
+  auto const with_margin = [](hal::time_duration p_measured,
+                              hal::time_duration p_ceiling) {
+    auto const scaled = std::chrono::duration_cast<hal::time_duration>(
+      p_measured * calibration_margin);
+    return std::clamp(scaled, min_phase_time, p_ceiling);
+  };
+
+  m_timing.integration =
+    with_margin(m_worst_integration, ceiling.integration);
+  m_timing.settle = with_margin(m_worst_settle, ceiling.settle);
+
+  m_active_timing.back() = m_timing;
+  m_active_timing.publish();
+  m_calibrating = false;
+}
+
+void diode_scanner::store_sample(irb_freq p_frequency)
+{
+  // Sample the analog value as a back to back burst of conversions
+  auto const burst = std::span(m_burst).first(m_oversampling.count);
+  for (auto& reading : burst) {
+    reading = m_resources.intensity.read();
+  }
+  auto const reading = reduce(burst, m_oversampling.filter);
+
+  // Map float to u16 relative to the reference ratio
+  auto const mapped_reading =
+    hal::map(reading, { 0.0f, m_reference }, { 0.0f, 65535.0f });
+  auto const clamped_value =
+    std::clamp(static_cast<int>(mapped_reading), 0, 65535);
+
+  auto& working = m_working[index(p_frequency)];
+  working.intensity[m_diode] = static_cast<hal::u16>(clamped_value);
+  working.samples[m_diode] = static_cast<hal::u8>(clamped_value >> 8);
+}
+
+hal::time_duration diode_scanner::next_diode()
+{
+  using namespace std::chrono_literals;
+
+  m_diode++;
+  if (m_diode < diode_count) {
+    m_state = state::clock_high;
+    return 0us;
+  }
+
+  m_resources.counter_reset.level(true);
+  m_resources.counter_clock.level(true);
+
+  auto const publish = [this](irb_freq p_frequency) {
+    auto& working = m_working[index(p_frequency)];
+    working.reference = m_reference;
+    working.frequency = p_frequency;
+    working.completed_at = m_resources.clock.uptime();
+    auto& results = m_results[index(p_frequency)];
+    results.back() = working;
+    results.publish();
+  };
+
+  if (m_mode == sweep_mode::interleaved) {
+    publish(irb_freq::low);
+    publish(irb_freq::high);
+  } else {
+    publish(m_frequency);
+    // Alternate between the two frequencies for every sweep
+    m_frequency =
+      (m_frequency == irb_freq::low) ? irb_freq::high : irb_freq::low;
+  }
+
+  if (m_calibration_sweeps > 0) {
+    m_calibration_sweeps--;
+    if (m_calibration_sweeps == 0) {
+      finish_calibration();
+    }
+  }
+
+  m_state = state::begin_sweep;
+  return 0us;
+}
+
+hal::time_duration diode_scanner::step()
+{
+  using namespace std::chrono_literals;
+
+  switch (m_state) {
+    case state::begin_sweep: {
+      // Timing changes only take effect between sweeps
+      if (m_applied_generation != m_requested_timing.generation()) {
+        m_applied_generation = m_requested_timing.generation();
+        m_timing = m_requested_timing.read();
+        m_active_timing.back() = m_timing;
+        m_active_timing.publish();
+      }
+
+      if (m_calibrate_requested.exchange(false)) {
+        // Calibrate one sweep per frequency against the known safe timing
+        m_calibrating = true;
+        m_calibration_sweeps = 2;
+        m_timing.integration = diode_timing{}.integration;
+        m_timing.settle = diode_timing{}.settle;
+        m_worst_integration = 0us;
+        m_worst_settle = 0us;
+      }
+
+      m_mode = m_requested_mode.load();
+      m_oversampling = m_requested_oversampling.load();
+      if (m_mode == sweep_mode::interleaved) {
+        // Both channels are sampled each diode, low is always read first
+        m_frequency = irb_freq::low;
+      }
+
+      m_resources.frequency_select.level(m_frequency == irb_freq::high);
+      // Voltage divider's voltage (max expected voltage from the sensor) is
+      // only converted when the tracker's period has elapsed.
+      m_reference_tracker.update();
+      m_reference = m_reference_tracker.value();
+      m_diode = 0;
+      // Reset IRB hardware counter used to multiplex/select the photo diode
+      // to sample
+      m_resources.counter_reset.level(true);
+      m_state = state::release_reset;
+      // Wait to allow reset to take hold
+      return m_timing.reset_hold;
+    }
+    case state::release_reset: {
+      // Clear counter reset, photo-diode 0 should be accumulating charge
+      m_resources.counter_reset.level(false);
+      m_state = state::clock_high;
+      return 0us;
+    }
+    case state::clock_high: {
+      m_resources.counter_clock.level(true);
+      if (m_calibration_sweeps > 0) {
+        m_trace_length = 0;
+        m_trace_elapsed = 0us;
+        m_state = state::integrating;
+        return calibration_interval;
+      }
+      m_state = state::clock_low;
+      return m_timing.integration;
+    }
+    case state::integrating: {
+      auto const delay =
+        trace_intensity(m_timing.integration, m_worst_integration);
+      if (delay != 0us) {
+        return delay;
+      }
+      m_state = state::clock_low;
+      return 0us;
+    }
+    case state::clock_low: {
+      // Increment the counter to the next photo-diode
+      m_resources.counter_clock.level(false);
+      if (m_calibration_sweeps > 0) {
+        m_trace_length = 0;
+        m_trace_elapsed = 0us;
+        m_state = state::settling;
+        return calibration_interval;
+      }
+      m_state = state::sample;
+      return m_timing.settle;
+    }
+    case state::settling: {
+      auto const delay = trace_intensity(m_timing.settle, m_worst_settle);
+      if (delay != 0us) {
+        return delay;
+      }
+      m_state = state::sample;
+      return 0us;
+    }
+    case state::sample: {
+      store_sample(m_frequency);
+
+      if (m_mode == sweep_mode::interleaved) {
+        // Switch to the high channel on the same diode before advancing
+        m_resources.frequency_select.level(true);
+        m_state = state::sample_high;
+        return m_timing.frequency_settle;
+      }
+
+      return next_diode();
+    }
+    case state::sample_high: {
+      store_sample(irb_freq::high);
+      // Low channel settles while the next diode integrates
+      m_resources.frequency_select.level(false);
+      return next_diode();
+    }
+  }
+
+  return 0us;
+}
+}  // namespace e10
@@ -0,0 +1,287 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+
+#include <huskylens.hpp>
+#include <log.hpp>
+#include <profile.hpp>
+
+namespace e10::huskylens {
+void send_algorithm_change(camera_link& p_link, hal::byte p_algorithm)
+{
+  // Same layout as the knock, the algorithm is the first payload byte
+  std::array<hal::byte, 16> change_bytes{ header1,
+                                          header2,
+                                          change_algorithm_cmd,
+                                          p_algorithm,
+                                          change_algorithm_length,
+                                          p_algorithm };
+  change_bytes.back() = std::accumulate(
+    change_bytes.begin(), change_bytes.end() - 1, hal::byte{ 0 });
+
+  p_link.write(change_bytes);
+}
+
+bool algorithm_accepted(std::span<hal::byte> p_all_data_buffer,
+                        camera_link& p_link,
+                        hal::serial& p_console,
+                        hal::byte p_algorithm)
+{
+  std::span<hal::byte> ok_buffer =
+    read_response_data(p_all_data_buffer, p_link);
+
+  if (ok_buffer[1] != result_ok) {
+    e10::log<log_level::warning>(
+      p_console, "Camera rejected algorithm %u\n", unsigned{ p_algorithm });
+    return false;
+  }
+  e10::log<log_level::info>(
+    p_console, "Camera algorithm %u\n", unsigned{ p_algorithm });
+  return true;
+}
+
+void send_knock(camera_link& p_link, hal::serial& p_console)
+{
+  constexpr std::array<hal::byte, 16> knock_bytes{
+    header1,      header2,
+    knock_cmd,    any_algo,
+    knock_length, 0x00,
+    0x00,         0x00,
+    0x00,         0x00,
+    0x00,         0x00,
+    0x00,         0x00,
+    0x00,         hal::byte(header1 + header2 + knock_length)
+  };
+  // get rid of any previous data hanging in buffer
+  drain_camera(p_link, p_console);
+  // knock camera to handshake, the response is read once the camera had time
+  // to answer
+  p_link.write(knock_bytes);
+}
+
+bool knock_accepted(std::span<hal::byte> p_all_data_buffer,
+                    camera_link& p_link,
+                    hal::serial& p_console)
+{
+  std::span<hal::byte> ok_buffer =
+    read_response_data(p_all_data_buffer, p_link);
+
+  e10::log<log_level::debug>(p_console, "Knock Response: ");
+  for (hal::byte i : ok_buffer) {
+    e10::log<log_level::debug>(p_console, "0x%02X ", unsigned{ i });
+  }
+  e10::log<log_level::debug>(p_console, "\n");
+
+  if (ok_buffer[1] != result_ok) {
+    e10::log<log_level::warning>(p_console, "Camera knock not ok.\n");
+    return false;
+  }
+  return true;
+}
+
+void drain_camera(camera_link& p_link, hal::serial& p_console)
+{
+  if (p_link.drain() == camera_link::outcome::budget_exhausted) {
+    e10::log<log_level::warning>(p_console, "Camera drain budget exhausted\n");
+  }
+}
+
+std::span<hal::byte> read_response_data(std::span<hal::byte> p_all_data_buffer,
+                                        camera_link& p_link)
+{
+  profile_scope const profile(profile_zone::camera_response);
+  // Most bytes skipped while looking for the header before giving up
+  constexpr std::size_t max_skipped_bytes = 64;
+
+  // error bytes to be sent in case of error, last byte is a variable to
+  // describe what error occurred
+  // 0x01 = header1 mismatch
+  // 0x02 = header2 mismatch
+  // 0x03 = response too long for the buffer
+  std::span<hal::byte> error_bytes = p_all_data_buffer.subspan(0, 3);
+  error_bytes[0] = 0xDE;
+  error_bytes[1] = 0xAD;
+
+  // Read header, command, algorithm and length in a single transaction. If
+  // the read did not start on the header, keep everything from the first
+  // header1 byte onward and read only the missing bytes.
+  std::array<hal::byte, 5> header{};
+  std::size_t received = 0;
+  std::size_t skipped = 0;
+  while (true) {
+    p_link.read(std::span(header).subspan(received));
+
+    std::size_t start = 0;
+    while (start < header.size() &&
+           not(header[start] == header1 &&
+               (start + 1 == header.size() || header[start + 1] == header2))) {
+      start++;
+    }
+    if (start == 0) {
+      break;
+    }
+
+    skipped += start;
+    if (skipped >= max_skipped_bytes) {
+      auto const found_header1 = start < header.size();
+      error_bytes[2] = found_header1 ? 0x02 : 0x01;
+      return error_bytes;
+    }
+    std::copy(header.begin() + start, header.end(), header.begin());
+    received = header.size() - start;
+  }
+
+  hal::byte const cmd = header[2];
+  hal::byte const algo = header[3];
+  uint8_t const data_length = header[4];
+  if (data_length + 3u > p_all_data_buffer.size()) {
+    error_bytes[2] = 0x03;
+    return error_bytes;
+  }
+
+  std::span<hal::byte> data_buffer =
+    p_all_data_buffer.subspan(0, data_length + 3);
+  data_buffer[0] = cmd;
+  // Read the payload and the checksum that follows it in a single transaction
+  p_link.read(data_buffer.subspan(1, data_length + 1));
+
+  hal::byte calculated_checksum = header1 + header2 + cmd + algo + data_length;
+  for (uint8_t i = 0; i < data_length; i++) {
+    calculated_checksum += data_buffer[i + 1];
+  }
+
+  // get checksum from camera
+  hal::byte received_check_sum = data_buffer[data_length + 1];
+  data_buffer[data_length + 2] = calculated_checksum;
+
+  if (received_check_sum != calculated_checksum) {
+    // checksum mismatch, send anyways but change cmd
+    data_buffer[0] += 0x10;
+  }
+
+  return data_buffer;
+}
+
+camera_frame get_camera_data(std::span<hal::byte> p_all_data_buffer,
+                             camera_link& p_link,
+                             hal::serial& p_console,
+                             hal::byte p_algorithm)
+{
+  using namespace std::chrono_literals;
+
+  profile_scope const profile(profile_zone::camera_read);
+  camera_frame frame{};
+  bool block_found = false;
+
+  std::array<hal::byte, 6> const request_blocks_bytes{
+    header1,
+    header2,
+    request_blocks_cmd,
+    p_algorithm,
+    0x00,
+    hal::byte(header1 + header2 + request_blocks_cmd + p_algorithm)
+  };
+
+  // Decode a block or arrow response into the next object slot. The first
+  // block is also kept in the 'c' format.
+  auto const store_object = [&frame, &block_found, &p_console](
+                              std::span<hal::byte const> p_response) {
+    // Command, ID, a reserved byte and the 8 geometry bytes
+    constexpr std::size_t object_response_size = 11;
+    auto const command = p_response[0];
+    if ((command != block_response && command != arrow_response) ||
+        p_response.size() < object_response_size) {
+      return false;
+    }
+
+    auto& object = frame.objects[frame.object_count];
+    object.id = p_response[1];
+    object.kind = (command == block_response)
+                    ? protocol::camera_object::block
+                    : protocol::camera_object::arrow;
+    std::copy_n(p_response.begin() + 3, object.geometry.size(),
+                object.geometry.begin());
+    frame.object_count++;
+
+    if (command == block_response && not block_found) {
+      block_found = true;
+      uint16_t x = (p_response[4] << 8) | p_response[3];
+      uint16_t y = (p_response[6] << 8) | p_response[5];
+      e10::log<log_level::debug>(
+        p_console, "X: %u   Y: %u\n", unsigned{ x }, unsigned{ y });
+      std::ranges::copy(object.geometry, frame.block.begin());
+      frame.block[8] = std::accumulate(
+        object.geometry.begin(), object.geometry.end(), hal::byte{ 0 });
+    }
+    return true;
+  };
+
+  auto const log_unknown = [&p_console](std::span<hal::byte const> p_response) {
+    e10::log<log_level::warning>(p_console, "Unknown Response: ");
+    for (hal::byte i : p_response) {
+      e10::log<log_level::warning>(p_console, "0x%02X ", i);
+    }
+    e10::log<log_level::warning>(p_console, "\n");
+  };
+
+  try {
+    // request and read back data
+    p_link.write(request_blocks_bytes);
+
+    // An info response announces how many objects follow it. Without one the
+    // camera answered with a single object. A response that cannot be parsed
+    // costs a resync, parsing resumes at the next header the resync finds.
+    constexpr std::size_t max_reads = protocol::max_camera_objects + 2;
+    std::size_t expected = 1;
+    bool info_received = false;
+    bool drain_needed = false;
+    for (std::size_t reads = 0; reads < max_reads && expected > 0; reads++) {
+      std::span<hal::byte> read_buffer =
+        read_response_data(p_all_data_buffer, p_link);
+      if (not info_received &&
+          (read_buffer[0] == 0x1B || read_buffer[0] == 0x2B)) {
+        // Objects past the capacity are left to the drain
+        std::size_t const reported = read_buffer[1];
+        expected = std::min(reported, frame.objects.size());
+        drain_needed = reported > expected;
+        info_received = true;
+        continue;
+      }
+      if (store_object(read_buffer)) {
+        expected--;
+        continue;
+      }
+
+      log_unknown(read_buffer);
+      if (p_link.resync() != camera_link::outcome::found_header) {
+        e10::log<log_level::warning>(p_console, "Camera resync failed\n");
+        break;
+      }
+    }
+    if (drain_needed) {
+      drain_camera(p_link, p_console);
+    }
+  } catch (...) {
+    e10::log<log_level::warning>(p_console, "NACK\n");
+    drain_camera(p_link, p_console);
+  }
+  return frame;
+}
+}  // namespace e10::huskylens
@@ -19,10 +19,11 @@
 #include <algorithm>
 #include <array>
 #include <numeric>
+#include <optional>
+#include <span>
 
-#include <libhal-exceptions/control.hpp>
+#include <libhal-util/enum.hpp>
 #include <libhal-util/i2c.hpp>
-#include <libhal-util/map.hpp>
 #include <libhal-util/serial.hpp>
 #include <libhal-util/steady_clock.hpp>
 #include <libhal/error.hpp>
@@ -33,53 +34,121 @@
 #include <libhal/timeout.hpp>
 #include <libhal/units.hpp>
 
+#include <bearing.hpp>
+#include <camera_connection.hpp>
+#include <camera_link.hpp>
+#include <camera_poller.hpp>
+#include <camera_service.hpp>
+#include <command_metrics.hpp>
+#include <command_queue.hpp>
+#include <counting_i2c.hpp>
+#include <diode_scanner.hpp>
+#include <e10_protocol.hpp>
+#include <huskylens.hpp>
+#include <link_rate.hpp>
+#include <log.hpp>
+#include <profile.hpp>
 #include <resource_list.hpp>
+#include <stream_subscription.hpp>
 
 void application();
 
-struct sample_args
-{
-  hal::output_pin& counter_reset;
-  hal::output_pin& counter_clock;
-  hal::adc& intensity;
-  hal::adc& reference;
-  hal::steady_clock& clock;
-};
+using e10::irb_freq;
+using e10::log_level;
+namespace huskylens = e10::huskylens;
 
-enum class irb_freq : hal::u8
+/// Commands received on both ports that wait to be handled
+using adapter_command_queue = e10::command_queue<4>;
+
+/**
+ * @brief Resources and state shared by the command handlers
+ *
+ */
+struct command_context
 {
-  low = 0,
-  high = 1,
+  e10::diode_scanner& scanner;
+  hal::serial& console;
+  e10::counting_i2c& i2c;
+  e10::camera_link& camera_link;
+  hal::steady_clock& clock;
+  e10::link_rate& link_rate;
+  e10::camera_poller& camera;
+  e10::camera_connection& camera_connection;
+  e10::camera_service& camera_service;
+  e10::stream_subscription& stream;
+  /// Port the command being handled was received on
+  hal::serial* requester = nullptr;
+  /// Latency histograms of the handled commands
+  e10::command_metrics metrics{};
+  /// Reader of the RS485 link, for its error counters
+  e10::command_reader const* rs485_reader = nullptr;
+  /// Queue of received commands, for its drop counter
+  adapter_command_queue const* commands = nullptr;
 };
 
-std::array<hal::byte, 8> sample_all_diodes(sample_args p_args);
+/**
+ * @brief Run one command and build its response
+ *
+ * The same handlers answer the single byte commands and the framed protocol.
+ *
+ * @param p_context - resources and state of the adapter
+ * @param p_command - command byte, see e10::protocol::command
+ * @param p_payload - request payload of e10::protocol::payload_size() bytes
+ * @param p_protocol - protocol version to format the response in
+ * @param p_printable - print a human readable answer to the console instead of
+ * a binary response, for commands that support it.
+ * @param p_response - buffer to build the response in
+ * @return std::optional<std::span<hal::byte const>> - response bytes within
+ * p_response, empty if the answer was printed. std::nullopt if the command is
+ * unknown or its payload was rejected.
+ */
+std::optional<std::span<hal::byte const>> handle_command(
+  command_context& p_context,
+  hal::byte p_command,
+  std::span<hal::byte const> p_payload,
+  hal::byte p_protocol,
+  bool p_printable,
+  std::span<hal::byte> p_response);
+/**
+ * @brief Determine if the subscriber should be sent a snapshot
+ *
+ * @param p_context - resources and state of the adapter
+ * @return true - someone is subscribed, the period has passed and, if
+ * requested, a new sweep has completed since the last snapshot. false while
+ * a request is arriving on the RS485 link.
+ */
+bool snapshot_due(command_context const& p_context);
+/**
+ * @brief Push a snapshot frame to the subscriber
+ *
+ * @param p_context - resources and state of the adapter
+ * @param p_response - buffer to build the snapshot in
+ * @param p_frame - buffer to encode the frame in
+ */
+void push_snapshot(command_context& p_context,
+                   std::span<hal::byte> p_response,
+                   std::span<hal::byte> p_frame);
+/**
+ * @brief Send a response, logging a transmitter that timed out
+ *
+ * The RS485 driver gives up on a transmission that does not complete in time,
+ * which is logged rather than ending the main loop.
+ *
+ * @param p_port - port to send the response on
+ * @param p_data - response bytes
+ * @param p_console - console for diagnostics
+ */
+void send_response(hal::serial& p_port,
+                   std::span<hal::byte const> p_data,
+                   hal::serial& p_console);
 std::array<hal::byte, 3> get_strongest_signal(
   irb_freq p_freq,
   std::array<hal::byte, 8> const& p_samples);
-
-bool camera_init(std::span<hal::byte> p_all_data_buffer,
-                 hal::i2c& p_i2c,
-                 hal::serial& p_console,
-                 hal::steady_clock& p_clock);
-std::array<hal::byte, 9> get_camera_data(std::span<hal::byte> p_all_data_buffer,
-                                         hal::i2c& p_i2c,
-                                         hal::serial& p_console);
-void flush_buffer(hal::i2c& p_i2c, hal::serial& p_console);
-std::span<hal::byte> read_response_data(std::span<hal::byte> p_all_data_buffer,
-                                        hal::i2c& p_i2c);
-
-constexpr hal::byte camera_address = 0x50;
-constexpr hal::byte header1 = 0x55;
-constexpr hal::byte header2 = 0xAA;
-constexpr hal::byte any_algo = 0x00;
-[[maybe_unused]] constexpr hal::byte obj_tracking_algorithm = 0x03;
-
-constexpr hal::byte knock_cmd = 0x00;
-constexpr hal::byte knock_length = 0x0A;
-constexpr hal::byte request_blocks_cmd = 0x01;
-[[maybe_unused]] constexpr hal::byte change_algorithm_cmd = 0x0A;
-[[maybe_unused]] constexpr hal::byte change_algorithm_length = 0x0A;
-constexpr hal::byte result_ok = 0x00;
+e10::protocol::beacon_report make_beacon_report(
+  irb_freq p_freq,
+  std::array<hal::byte, 8> const& p_samples);
+std::array<hal::byte, 6> timing_response(e10::diode_timing const& p_timing,
+                                         bool p_calibrating);
 
 int main()
 {
@@ -95,222 +164,832 @@ constexpr std::string_view version = E10_ADAPTER_VERSION;
 
 void application()
 {
-  using namespace std::chrono_literals;
   std::array<hal::byte, 256> all_data_buffer{};
-  auto console = resources::console();
+  auto console_uart = resources::console();
+  // Console output is buffered and only sent while no command is waiting
+  e10::deferred_serial<1024> deferred_console(*console_uart);
+  auto* const console = &deferred_console;
   auto rs485_transceiver = resources::rs485_transceiver();
   auto device_clock = resources::clock();
-  auto transceiver_direction = resources::transceiver_direction();
   auto frequency_select = resources::frequency_select();
   auto counter_reset = resources::counter_reset();
   auto counter_clock = resources::counter_clock();
   auto intensity = resources::intensity();
   auto adc_reference = resources::adc_reference();
   auto i2c = resources::i2c();
+  e10::counting_i2c camera_bus(*i2c);
+  e10::camera_link camera_link(
+    camera_bus, *device_clock, huskylens::camera_address);
+  auto sequencer_timer = resources::sequencer_timer();
 
-  hal::print<64>(*console, "Starting application...\n");
-  bool camera_connected = false;
+  e10::diode_scanner scanner({ .counter_reset = *counter_reset,
+                               .counter_clock = *counter_clock,
+                               .frequency_select = *frequency_select,
+                               .intensity = *intensity,
+                               .reference = *adc_reference,
+                               .clock = *device_clock,
+                               .timer = *sequencer_timer });
+  scanner.start();
 
-  try {
-    camera_connected =
-      camera_init(all_data_buffer, *i2c, *console, *device_clock);
-  } catch (...) {
-    hal::print<64>(*console, "Camera not connected...\n");
+  e10::log<log_level::info>(*console, "Starting application...\n");
+  e10::link_rate link_rate(*device_clock);
+  e10::camera_poller camera(*device_clock);
+  e10::camera_connection camera_connection(*device_clock);
+  e10::camera_service camera_service({ .link = camera_link,
+                                       .poller = camera,
+                                       .connection = camera_connection,
+                                       .console = *console,
+                                       .buffer = all_data_buffer });
+  e10::stream_subscription stream(*device_clock);
+  command_context context{ .scanner = scanner,
+                           .console = *console,
+                           .i2c = camera_bus,
+                           .camera_link = camera_link,
+                           .clock = *device_clock,
+                           .link_rate = link_rate,
+                           .camera = camera,
+                           .camera_connection = camera_connection,
+                           .camera_service = camera_service,
+                           .stream = stream };
+  // Brains that never negotiate keep getting the original response formats
+  hal::byte rs485_protocol = e10::protocol::legacy_version;
+
+  // Make sure both frequencies have a real sweep to answer with before
+  // accepting commands.
+  while (scanner.sweeps_completed(irb_freq::low) == 0 or
+         scanner.sweeps_completed(irb_freq::high) == 0) {
+    deferred_console.drain();
   }
 
-  while (true) {
-    std::array<hal::byte, 1> read_bytes{};
-    // Put RS485 transceiver into read mode
-    transceiver_direction->level(false);
-    auto response = rs485_transceiver->read(read_bytes);
-
-    // Used by commands like 'v' to only respond to the serial port that
-    // requested the version.
-    bool command_found = false;
-    bool console_request = false;
-
-    if (response.data.size() == read_bytes.size()) {
-      // We received some data, put RS485 transceiver into send mode
-      transceiver_direction->level(true);
-      command_found = true;
-    } else {
-      response = console->read(read_bytes);
-      if (response.data.size() == read_bytes.size()) {
-        command_found = true;
-        console_request = true;
-      }
+  std::array<hal::byte, e10::protocol::max_payload_size> response_buffer{};
+  std::array<hal::byte, e10::protocol::max_frame_size> frame_buffer{};
+  adapter_command_queue commands;
+  e10::command_reader rs485_reader(*device_clock, false);
+  e10::command_reader console_reader(*device_clock, true);
+  e10::received_command received{};
+  context.rs485_reader = &rs485_reader;
+  context.commands = &commands;
+
+  // Baud rate changes only take effect once the response announcing them has
+  // left at the old rate.
+  auto rs485_baud_rate = link_rate.rate();
+  auto const apply_link_rate = [&]() {
+    if (link_rate.rate() == rs485_baud_rate) {
+      return;
     }
+    rs485_baud_rate = link_rate.rate();
+    rs485_transceiver->configure({ .baud_rate = rs485_baud_rate });
+    e10::log<log_level::info>(
+      *console, "RS485 baud rate: %" PRIu32 "\n", rs485_baud_rate);
+  };
 
-    // If a command wasn't received by either serial port, skip the rest of the
-    // loop.
-    if (not command_found) {
+  while (true) {
+    rs485_reader.poll(*rs485_transceiver, commands);
+    console_reader.poll(*console, commands);
+
+    if (not commands.pop(received)) {
+      // Nothing to answer, use the idle time to serve the subscriber, refresh
+      // the camera cache and drain the console, then sleep until something
+      // happens.
+      if (link_rate.revert_if_expired()) {
+        e10::log<log_level::warning>(*console, "Baud rate not confirmed\n");
+        apply_link_rate();
+      } else if (snapshot_due(context)) {
+        push_snapshot(context, response_buffer, frame_buffer);
+      } else if (not camera_service.step() &&
+                 deferred_console.drain() == 0) {
+        resources::wait_for_work();
+      }
       continue;
     }
 
+    hal::serial& requester =
+      received.console ? *console : *rs485_transceiver;
+    context.requester = &requester;
     auto const start = device_clock->uptime();
-    // process data
-    switch (read_bytes[0]) {
-      case 'v': {  // Version
-        hal::write(*console, version, hal::never_timeout());
-        hal::write(*rs485_transceiver, version, hal::never_timeout());
-        break;
-      }
-      case 'a': {  // Both low and high frequency signals
-        // Sample the voltage divider's voltage (max expected voltage from the
-        // sensor)
-        auto const reference_ratio = adc_reference->read();
-        // set frequency to low
-        frequency_select->level(false);
-        auto const low_frequency_samples =
-          sample_all_diodes({ .counter_reset = *counter_reset,
-                              .counter_clock = *counter_clock,
-                              .intensity = *intensity,
-                              .reference = *adc_reference,
-                              .clock = *device_clock });
-
-        // set frequency to high
-        frequency_select->level(true);
-        auto const high_frequency_samples =
-          sample_all_diodes({ .counter_reset = *counter_reset,
-                              .counter_clock = *counter_clock,
-                              .intensity = *intensity,
-                              .reference = *adc_reference,
-                              .clock = *device_clock });
-
-        if (console_request) {
-          hal::print<64>(*console, "Reference Ratio = %.6f\n", reference_ratio);
-          hal::print(*console, " Low Samples: [");
-          for (auto sample : low_frequency_samples) {
-            hal::print<64>(*console, "%03u, ", sample);
-          }
-          hal::print(*console, "]\n");
-          hal::print(*console, "High Samples: [");
-          for (auto sample : high_frequency_samples) {
-            hal::print<64>(*console, "%03u, ", sample);
-          }
-          hal::print(*console, "]\n");
-        } else {
-          // Calculate checksum
-          std::array<hal::u8, 1> checksum{};
-          checksum[0] = std::accumulate(
-            low_frequency_samples.begin(), low_frequency_samples.end(), 0);
-          checksum[0] = std::accumulate(high_frequency_samples.begin(),
-                                        high_frequency_samples.end(),
-                                        checksum[0]);
-
-          // Send data over
-          hal::write(
-            *rs485_transceiver, low_frequency_samples, hal::never_timeout());
-          hal::write(
-            *rs485_transceiver, high_frequency_samples, hal::never_timeout());
-          hal::write(*rs485_transceiver, checksum, hal::never_timeout());
-        }
-        break;
-      }
-      case 'l': {
-        // set frequency to low
-        frequency_select->level(false);
-        auto const low_frequency_samples =
-          sample_all_diodes({ .counter_reset = *counter_reset,
-                              .counter_clock = *counter_clock,
-                              .intensity = *intensity,
-                              .reference = *adc_reference,
-                              .clock = *device_clock });
-        auto const payload =
-          get_strongest_signal(irb_freq::low, low_frequency_samples);
-        hal::write(*rs485_transceiver, payload, hal::never_timeout());
-        break;
-      }
-      case 'h': {
-        // set frequency to high
-        frequency_select->level(true);
-        auto const high_frequency_samples =
-          sample_all_diodes({ .counter_reset = *counter_reset,
-                              .counter_clock = *counter_clock,
-                              .intensity = *intensity,
-                              .reference = *adc_reference,
-                              .clock = *device_clock });
-        auto const payload =
-          get_strongest_signal(irb_freq::high, high_frequency_samples);
-        hal::write(*rs485_transceiver, payload, hal::never_timeout());
-        break;
-      }
-      case 'c': {
-        std::array<hal::byte, 9> cam_data{ 0x00, 0x00, 0x00, 0x00, 0x00,
-                                           0x00, 0x00, 0x00, 0x00 };
-        try {
-          if (camera_connected) {
-            cam_data = get_camera_data(all_data_buffer, *i2c, *console);
-          } else {
-            hal::print<64>(*console, "Reconnecting Camera\n");
-            camera_connected =
-              camera_init(all_data_buffer, *i2c, *console, *device_clock);
-            cam_data = get_camera_data(all_data_buffer, *i2c, *console);
-          }
-        } catch (...) {
-          camera_connected = false;
-          hal::print<64>(*console, "Camera not connected...\n");
+
+    auto const& request = received.request;
+    auto const command = static_cast<e10::protocol::command>(request.command);
+    auto const payload = std::span(request.payload).first(request.length);
+    // Only answered commands get a latency histogram, so unknown bytes and
+    // rejected payloads cannot use up the histogram slots
+    bool answered = false;
+
+    if (received.framed) {
+      std::optional<std::span<hal::byte const>> result;
+      if (payload.size() == e10::protocol::payload_size(command)) {
+        result = handle_command(context,
+                                request.command,
+                                payload,
+                                e10::protocol::framed_version,
+                                false,
+                                response_buffer);
+      }
+
+      answered = result.has_value();
+      std::size_t frame_length = 0;
+      if (result) {
+        frame_length = e10::protocol::encode_frame(request.sequence,
+                                                   request.command,
+                                                   result->data(),
+                                                   result->size(),
+                                                   frame_buffer.data());
+      } else {
+        frame_length = e10::protocol::encode_frame(
+          request.sequence,
+          hal::value(e10::protocol::command::nack),
+          &request.command,
+          1,
+          frame_buffer.data());
+      }
+      send_response(
+        requester, std::span(frame_buffer).first(frame_length), *console);
+    } else {
+      auto const protocol =
+        received.console ? e10::protocol::legacy_version : rs485_protocol;
+      auto const result = handle_command(context,
+                                         request.command,
+                                         payload,
+                                         protocol,
+                                         received.console,
+                                         response_buffer);
+      answered = result.has_value();
+      if (result) {
+        send_response(requester, *result, *console);
+        if (command == e10::protocol::command::negotiate &&
+            not received.console) {
+          rs485_protocol = result->front();
         }
-        hal::write(*rs485_transceiver, cam_data, hal::never_timeout());
-        break;
       }
-      default:
-        hal::print<64>(*console, "Unknown read 0x%02X \n", read_bytes[0]);
-        break;
     }
 
+    apply_link_rate();
+
     auto const end = device_clock->uptime();
     auto const delta = (end - start);
-    hal::print<128>(
+    auto const delta_us = static_cast<float>(delta) * 1e6f /
+                          device_clock->frequency();
+    if (answered) {
+      context.metrics.record(request.command,
+                             static_cast<hal::u32>(delta_us));
+    }
+    e10::log<log_level::debug, 128>(
       *console, "t: %" PRIu64 ", f: %f\n", delta, device_clock->frequency());
-    // Wait before setting the transceiver into read mode
-    hal::delay(*device_clock, 100us);
   }
 }
 
-std::array<hal::byte, 8> sample_all_diodes(sample_args p_args)
+std::optional<std::span<hal::byte const>> handle_command(
+  command_context& p_context,
+  hal::byte p_command,
+  std::span<hal::byte const> p_payload,
+  hal::byte p_protocol,
+  bool p_printable,
+  std::span<hal::byte> p_response)
+{
+  auto& scanner = p_context.scanner;
+  auto& console = p_context.console;
+  // Copy a response into the response buffer
+  auto const reply = [p_response](auto const& p_bytes) {
+    std::ranges::copy(p_bytes, p_response.begin());
+    return std::span<hal::byte const>(p_response.first(std::size(p_bytes)));
+  };
+  // Returned when the answer was printed to the console
+  constexpr std::span<hal::byte const> printed{};
+
+  switch (p_command) {
+    case 'v': {  // Version
+      return reply(version);
+    }
+    case 'a': {  // Both low and high frequency signals
+      auto const low_sweep = scanner.latest(irb_freq::low);
+      auto const high_sweep = scanner.latest(irb_freq::high);
+      auto const& low_frequency_samples = low_sweep.samples;
+      auto const& high_frequency_samples = high_sweep.samples;
+      // Smoothed voltage divider's voltage (max expected voltage from the
+      // sensor)
+      auto const reference_ratio = scanner.reference();
+
+      if (p_printable) {
+        hal::print<64>(console, "Reference Ratio = %.6f\n", reference_ratio);
+        hal::print(console, " Low Samples: [");
+        for (auto sample : low_frequency_samples) {
+          hal::print<64>(console, "%03u, ", sample);
+        }
+        hal::print(console, "]\n");
+        hal::print(console, "High Samples: [");
+        for (auto sample : high_frequency_samples) {
+          hal::print<64>(console, "%03u, ", sample);
+        }
+        hal::print(console, "]\n");
+        return printed;
+      }
+
+      std::array<hal::byte, 17> payload{};
+      std::ranges::copy(low_frequency_samples, payload.begin());
+      std::ranges::copy(high_frequency_samples, payload.begin() + 8);
+      // Calculate checksum
+      payload[16] =
+        std::accumulate(payload.begin(), payload.end() - 1, hal::byte{ 0 });
+      return reply(payload);
+    }
+    case 'l':
+    case 'h': {
+      auto const frequency =
+        (p_command == 'h') ? irb_freq::high : irb_freq::low;
+      auto const sweep = scanner.latest(frequency);
+      if (p_protocol >= e10::protocol::compact_version) {
+        auto const report = make_beacon_report(frequency, sweep.samples);
+        return reply(e10::protocol::to_bytes(report));
+      }
+      return reply(get_strongest_signal(frequency, sweep.samples));
+    }
+    case 'n': {  // Negotiate protocol version, payload: requested version
+      if (p_payload[0] < e10::protocol::legacy_version) {
+        e10::log<log_level::warning>(console, "Bad negotiate payload\n");
+        return std::nullopt;
+      }
+
+      auto const accepted =
+        std::min(p_payload[0], e10::protocol::latest_version);
+      std::array<hal::byte, 2> const payload{ accepted, accepted };
+      return reply(payload);
+    }
+    case 'r': {  // Switch the RS485 baud rate, payload: baud rate index
+      // Only the RS485 link changes rate, the console cannot confirm it
+      if (p_context.requester == &console) {
+        e10::log<log_level::warning>(console, "Baud rate is RS485 only\n");
+        return std::nullopt;
+      }
+
+      auto const outcome = p_context.link_rate.request(p_payload[0]);
+      if (outcome == e10::link_rate::outcome::rejected) {
+        e10::log<log_level::warning>(console, "Bad baud rate payload\n");
+        return std::nullopt;
+      }
+
+      std::array<hal::byte, 2> const payload{ p_payload[0], p_payload[0] };
+      return reply(payload);
+    }
+    case 'p': {  // Interpolated bearing, payload: frequency (0 low, 1 high)
+      if (p_payload[0] > hal::value(irb_freq::high)) {
+        e10::log<log_level::warning>(console, "Bad bearing payload\n");
+        return std::nullopt;
+      }
+
+      auto const sweep = scanner.latest(static_cast<irb_freq>(p_payload[0]));
+      auto const bearing = e10::interpolate_bearing(sweep.intensity);
+
+      if (p_printable) {
+        hal::print<96>(console,
+                       "Bearing = %u/%u, Confidence = %u, Peak = %u\n",
+                       bearing.position,
+                       e10::bearing::steps_per_diode,
+                       bearing.confidence,
+                       bearing.peak);
+        return printed;
+      }
+
+      std::array<hal::byte, 5> payload{
+        static_cast<hal::byte>(bearing.position & 0xFF),
+        static_cast<hal::byte>(bearing.position >> 8),
+        bearing.confidence,
+        bearing.peak,
+      };
+      payload[4] =
+        std::accumulate(payload.begin(), payload.end() - 1, hal::byte{ 0 });
+      return reply(payload);
+    }
+    case 't': {  // Query diode integration and settle timing
+      auto const timing = scanner.timing();
+      if (p_printable) {
+        using std::chrono::microseconds;
+        hal::print<96>(
+          console,
+          "Integration = %uus, Settle = %uus, Calibrating = %d\n",
+          static_cast<unsigned>(
+            std::chrono::duration_cast<microseconds>(timing.integration)
+              .count()),
+          static_cast<unsigned>(
+            std::chrono::duration_cast<microseconds>(timing.settle).count()),
+          scanner.calibrating());
+        return printed;
+      }
+      return reply(timing_response(timing, scanner.calibrating()));
+    }
+    case 'T': {  // Override diode integration and settle timing
+      // Payload: integration us (u16 LE), settle us (u16 LE)
+      using std::chrono::microseconds;
+      auto timing = scanner.timing();
+      timing.integration = microseconds(p_payload[0] | (p_payload[1] << 8));
+      timing.settle = microseconds(p_payload[2] | (p_payload[3] << 8));
+
+      try {
+        scanner.set_timing(timing);
+      } catch (hal::argument_out_of_domain const&) {
+        e10::log<log_level::warning>(console, "Timing out of range\n");
+        return std::nullopt;
+      }
+
+      return reply(timing_response(timing, scanner.calibrating()));
+    }
+    case 'm': {  // Select sequential (0) or interleaved (1) sweeps
+      if (p_payload[0] > hal::value(e10::sweep_mode::interleaved)) {
+        e10::log<log_level::warning>(console, "Bad sweep mode payload\n");
+        return std::nullopt;
+      }
+
+      scanner.set_mode(static_cast<e10::sweep_mode>(p_payload[0]));
+      std::array<hal::byte, 2> const payload{ p_payload[0], p_payload[0] };
+      return reply(payload);
+    }
+    case 'o': {  // Oversampling: reading count (1-16) and filter
+      if (p_payload[1] > hal::value(e10::sample_filter::trimmed_mean)) {
+        e10::log<log_level::warning>(console, "Bad oversampling payload\n");
+        return std::nullopt;
+      }
+
+      try {
+        scanner.set_oversampling({
+          .count = p_payload[0],
+          .filter = static_cast<e10::sample_filter>(p_payload[1]),
+        });
+      } catch (hal::argument_out_of_domain const&) {
+        e10::log<log_level::warning>(console,
+                                     "Oversampling count out of range\n");
+        return std::nullopt;
+      }
+
+      std::array<hal::byte, 3> const payload{
+        p_payload[0],
+        p_payload[1],
+        static_cast<hal::byte>(p_payload[0] + p_payload[1]),
+      };
+      return reply(payload);
+    }
+    case 'b': {  // Modeled time to refresh both frequency channels
+      using std::chrono::duration_cast;
+      using std::chrono::microseconds;
+      auto const timing = scanner.timing();
+      auto const sequential_us = static_cast<hal::u32>(
+        duration_cast<microseconds>(
+          e10::dual_sweep_duration(timing, e10::sweep_mode::sequential))
+          .count());
+      auto const interleaved_us = static_cast<hal::u32>(
+        duration_cast<microseconds>(
+          e10::dual_sweep_duration(timing, e10::sweep_mode::interleaved))
+          .count());
+
+      if (p_printable) {
+        hal::print<96>(console,
+                       "Sequential = %" PRIu32 "us, Interleaved = %" PRIu32
+                       "us, Active = %u\n",
+                       sequential_us,
+                       interleaved_us,
+                       hal::value(scanner.mode()));
+        return printed;
+      }
+
+      std::array<hal::byte, 9> payload{};
+      for (std::size_t i = 0; i < 4; i++) {
+        payload[i] = static_cast<hal::byte>(sequential_us >> (8 * i));
+        payload[i + 4] = static_cast<hal::byte>(interleaved_us >> (8 * i));
+      }
+      payload[8] =
+        std::accumulate(payload.begin(), payload.end() - 1, hal::byte{ 0 });
+      return reply(payload);
+    }
+    case 'C': {  // Measure the cost of reading the camera
+      constexpr hal::u8 calls = 16;
+      if (not p_context.camera_connection.ready()) {
+        e10::log<log_level::warning>(console, "Camera not ready\n");
+        return std::nullopt;
+      }
+
+      auto& bus = p_context.i2c;
+      auto const start_bytes = bus.bytes();
+      auto const start_transactions = bus.transactions();
+      auto const start = p_context.clock.uptime();
+      for (hal::u8 i = 0; i < calls; i++) {
+        // A failed read already marked the camera as lost
+        if (not p_context.camera_service.read()) {
+          return std::nullopt;
+        }
+      }
+      auto const elapsed = p_context.clock.uptime() - start;
+
+      // Both backends wait on the bus with the CPU, so the elapsed time is
+      // also the CPU time spent per call.
+      auto const seconds =
+        static_cast<float>(elapsed) / p_context.clock.frequency();
+      auto const us_per_call =
+        static_cast<hal::u32>(seconds * 1'000'000.0f / calls);
+      auto const bytes_per_second =
+        static_cast<hal::u32>((bus.bytes() - start_bytes) / seconds);
+      auto const transactions_per_call =
+        static_cast<hal::u8>((bus.transactions() - start_transactions) / calls);
+
+      if (p_printable) {
+        hal::print<128>(console,
+                        "Backend = %s, %" PRIu32 "us per call, %" PRIu32
+                        " B/s, %u transactions per call\n",
+                        E10_HARDWARE_I2C ? "hardware" : "bit bang",
+                        us_per_call,
+                        bytes_per_second,
+                        unsigned{ transactions_per_call });
+        return printed;
+      }
+
+      std::array<hal::byte, 11> payload{};
+      payload[0] = E10_HARDWARE_I2C;
+      for (std::size_t i = 0; i < 4; i++) {
+        payload[i + 1] = static_cast<hal::byte>(us_per_call >> (8 * i));
+        payload[i + 5] = static_cast<hal::byte>(bytes_per_second >> (8 * i));
+      }
+      payload[9] = transactions_per_call;
+      payload[10] =
+        std::accumulate(payload.begin(), payload.end() - 1, hal::byte{ 0 });
+      return reply(payload);
+    }
+    case 'k': {  // Calibrate diode integration and settle timing
+      scanner.calibrate();
+      if (p_printable) {
+        hal::print(console, "Calibrating...\n");
+        return printed;
+      }
+      return reply(timing_response(scanner.timing(), true));
+    }
+    case 'c': {  // Latest camera block from the cache
+      return reply(p_context.camera.latest().block);
+    }
+    case 'd': {  // Every cached camera object, payload: most objects
+      auto const requested = p_payload[0];
+      if (requested == 0 || requested > e10::protocol::max_camera_objects) {
+        e10::log<log_level::warning>(console, "Bad camera objects payload\n");
+        return std::nullopt;
+      }
+
+      auto const& frame = p_context.camera.latest();
+      auto const count = std::min(frame.object_count, requested);
+
+      if (p_printable) {
+        // Each geometry value is 16-bit, low byte first
+        auto const value = [](e10::protocol::camera_object const& p_object,
+                              std::size_t p_index) {
+          return unsigned(p_object.geometry[2 * p_index] |
+                          (p_object.geometry[2 * p_index + 1] << 8));
+        };
+        hal::print<64>(console, "Objects = %u\n", unsigned{ count });
+        for (std::size_t i = 0; i < count; i++) {
+          auto const& object = frame.objects[i];
+          hal::print<96>(
+            console,
+            "  ID = %u, %s = [%u, %u, %u, %u]\n",
+            unsigned{ object.id },
+            object.kind == object.arrow ? "Arrow" : "Block",
+            value(object, 0),
+            value(object, 1),
+            value(object, 2),
+            value(object, 3));
+        }
+        return printed;
+      }
+
+      constexpr auto object_size = sizeof(e10::protocol::camera_object);
+      std::array<hal::byte,
+                 e10::protocol::camera_objects_size(
+                   e10::protocol::max_camera_objects)>
+        payload{};
+      auto const length = e10::protocol::camera_objects_size(requested);
+      payload[0] = count;
+      for (std::size_t i = 0; i < count; i++) {
+        auto const& object = frame.objects[i];
+        auto* const entry = &payload[1 + (i * object_size)];
+        entry[0] = object.id;
+        entry[1] = object.kind;
+        std::ranges::copy(object.geometry, entry + 2);
+      }
+      payload[length - 1] = std::accumulate(
+        payload.begin(), payload.begin() + length - 1, hal::byte{ 0 });
+      return reply(std::span(payload).first(length));
+    }
+    case 'A': {  // Select the camera algorithm, payload: algorithm ID
+      auto const algorithm = p_payload[0];
+      auto& camera = p_context.camera;
+      std::array<hal::byte, 2> const payload{ algorithm, algorithm };
+      if (algorithm == camera.algorithm()) {
+        return reply(payload);
+      }
+
+      // The change is sent and its answer read from the main loop, so the
+      // camera's settle time does not hold up this or any other command.
+      // Requests for any algorithm carry the ID themselves and a disconnected
+      // camera is told once it is reconnected.
+      auto& connection = p_context.camera_connection;
+      if (algorithm == huskylens::any_algo) {
+        connection.cancel_algorithm_change();
+      } else {
+        connection.change_algorithm();
+      }
+      camera.select(algorithm);
+      return reply(payload);
+    }
+    case 'R': {  // Camera resynchronisation counters
+      auto const& stats = p_context.camera_link.stats();
+      if (p_printable) {
+        hal::print<128>(console,
+                        "Resyncs = %" PRIu32 ", Recovered = %" PRIu32
+                        ", Drains = %" PRIu32 ", Discarded = %" PRIu32
+                        " B, Budget exhausted = %" PRIu32 "\n",
+                        stats.resyncs,
+                        stats.recovered,
+                        stats.drains,
+                        stats.bytes_discarded,
+                        stats.budget_exhausted);
+        return printed;
+      }
+
+      std::array<hal::u32, 5> const counters{ stats.resyncs,
+                                              stats.recovered,
+                                              stats.drains,
+                                              stats.bytes_discarded,
+                                              stats.budget_exhausted };
+      std::array<hal::byte, 21> payload{};
+      for (std::size_t i = 0; i < counters.size(); i++) {
+        for (std::size_t byte = 0; byte < 4; byte++) {
+          payload[(i * 4) + byte] =
+            static_cast<hal::byte>(counters[i] >> (8 * byte));
+        }
+      }
+      payload[20] =
+        std::accumulate(payload.begin(), payload.end() - 1, hal::byte{ 0 });
+      return reply(payload);
+    }
+    case 'M': {  // Metrics, payload: 0 counters, 0xFF overflow, else command
+      auto const& metrics = p_context.metrics;
+      constexpr auto overflow = e10::command_metrics::overflow_command;
+      auto const selected = p_payload[0];
+      // Little endian u32 fields, followed by the checksum
+      auto const write_u32 = [p_response](std::size_t p_offset,
+                                          hal::u32 p_value) {
+        for (std::size_t byte = 0; byte < 4; byte++) {
+          p_response[p_offset + byte] =
+            static_cast<hal::byte>(p_value >> (8 * byte));
+        }
+      };
+      auto const finish = [p_response](std::size_t p_length) {
+        p_response[p_length] = std::accumulate(p_response.begin(),
+                                               p_response.begin() + p_length,
+                                               hal::byte{ 0 });
+        return std::span<hal::byte const>(p_response.first(p_length + 1));
+      };
+
+      if (selected == 0) {
+        auto const& rs485 = *p_context.rs485_reader;
+        std::array<hal::u32, 6> const counters{
+          rs485.checksum_errors(),
+          rs485.frames().crc_errors(),
+          p_context.i2c.failures(),
+          p_context.camera_link.stats().drains,
+          rs485.overruns(),
+          static_cast<hal::u32>(p_context.commands->dropped()),
+        };
+        std::array<hal::byte, e10::command_metrics::command_slots> tracked{};
+        auto const tracked_count = metrics.commands(tracked);
+
+        if (p_printable) {
+          hal::print<192>(console,
+                          "Checksum errors = %" PRIu32 ", CRC errors = %" PRIu32
+                          ", Camera NACKs = %" PRIu32 ", Camera drains = %" PRIu32
+                          ", RS485 overruns = %" PRIu32
+                          ", Dropped commands = %" PRIu32 "\n",
+                          counters[0],
+                          counters[1],
+                          counters[2],
+                          counters[3],
+                          counters[4],
+                          counters[5]);
+          for (auto const tracked_command :
+               std::span(tracked).first(tracked_count)) {
+            auto const& histogram = *metrics.find(tracked_command);
+            hal::print<96>(console,
+                           "'%c': count = %" PRIu32 ", max = %" PRIu32 "us\n",
+                           tracked_command == overflow ? '?' : tracked_command,
+                           histogram.count(),
+                           histogram.max());
+          }
+          return printed;
+        }
+
+        std::size_t length = 0;
+        for (auto const counter : counters) {
+          write_u32(length, counter);
+          length += 4;
+        }
+        p_response[length++] = static_cast<hal::byte>(tracked_count);
+        std::ranges::copy(std::span(tracked).first(tracked_count),
+                          p_response.begin() + length);
+        return finish(length + tracked_count);
+      }
+
+      constexpr e10::latency_histogram never_recorded{};
+      auto const* found = metrics.find(selected);
+      auto const& histogram = found ? *found : never_recorded;
+      if (p_printable) {
+        hal::print<96>(console,
+                       "'%c': count = %" PRIu32 ", max = %" PRIu32
+                       "us\nBuckets: [",
+                       selected == overflow ? '?' : selected,
+                       histogram.count(),
+                       histogram.max());
+        for (auto const count : histogram.buckets()) {
+          hal::print<16>(console, "%" PRIu32 ", ", count);
+        }
+        hal::print(console, "]\n");
+        return printed;
+      }
+
+      p_response[0] = selected;
+      write_u32(1, histogram.count());
+      write_u32(5, histogram.max());
+      std::size_t length = 9;
+      for (auto const count : histogram.buckets()) {
+        write_u32(length, count);
+        length += 4;
+      }
+      return finish(length);
+    }
+    case 'P': {  // Profiled zone costs, payload: reset afterwards (0 or 1)
+      if (p_payload[0] > 1) {
+        e10::log<log_level::debug>(console, "Bad profile payload\n");
+        return std::nullopt;
+      }
+      auto const frequency =
+        e10::profile_frequency(p_context.clock.frequency());
+      auto const table = e10::profile_snapshot();
+      // Zones compiled out are not reported
+      std::size_t const zones =
+        e10::profiling_enabled ? e10::profile_zone_count : 0;
+
+      if (p_printable) {
+        hal::print<64>(console,
+                       "Zones = %u, Ticks/s = %" PRIu32 "\n",
+                       unsigned(zones),
+                       frequency);
+        for (std::size_t zone = 0; zone < zones; zone++) {
+          auto const& stats = table[zone];
+          auto const mean = stats.count ? stats.total / stats.count : 0;
+          hal::print<160>(console,
+                          "%s: count = %" PRIu32 ", min = %" PRIu32
+                          ", max = %" PRIu32 ", mean = %" PRIu64
+                          " ticks (%.1fus)\n",
+                          e10::profile_zone_names[zone],
+                          stats.count,
+                          stats.count ? stats.min : 0,
+                          stats.max,
+                          mean,
+                          static_cast<float>(mean) * 1e6f /
+                            static_cast<float>(frequency));
+        }
+        if (p_payload[0] == 1) {
+          e10::profile_reset();
+        }
+        return printed;
+      }
+
+      std::size_t length = 0;
+      auto const append = [p_response, &length](hal::u64 p_value,
+                                                std::size_t p_bytes) {
+        for (std::size_t byte = 0; byte < p_bytes; byte++) {
+          p_response[length++] =
+            static_cast<hal::byte>(p_value >> (8 * byte));
+        }
+      };
+      append(frequency, 4);
+      append(zones, 1);
+      for (std::size_t zone = 0; zone < zones; zone++) {
+        auto const& stats = table[zone];
+        append(stats.count, 4);
+        append(stats.count ? stats.min : 0, 4);
+        append(stats.max, 4);
+        append(stats.total, 8);
+      }
+      p_response[length] = std::accumulate(
+        p_response.begin(), p_response.begin() + length, hal::byte{ 0 });
+      if (p_payload[0] == 1) {
+        e10::profile_reset();
+      }
+      return std::span<hal::byte const>(p_response.first(length + 1));
+    }
+    case 'g': {  // Age of the cached camera block
+      auto const age_ms = p_context.camera.age_ms();
+      if (p_printable) {
+        hal::print<64>(console,
+                       "Camera age = %ums, Connected = %d\n",
+                       unsigned{ age_ms },
+                       p_context.camera_connection.connected());
+        return printed;
+      }
+
+      std::array<hal::byte, 4> payload{
+        static_cast<hal::byte>(age_ms & 0xFF),
+        static_cast<hal::byte>(age_ms >> 8),
+        p_context.camera_connection.connected(),
+      };
+      payload[3] =
+        std::accumulate(payload.begin(), payload.end() - 1, hal::byte{ 0 });
+      return reply(payload);
+    }
+    case 'u': {  // Push snapshots, payload: period ms (u16 LE), on change
+      if (p_payload[2] > 1) {
+        e10::log<log_level::warning>(console, "Bad subscribe payload\n");
+        return std::nullopt;
+      }
+
+      auto const period_ms =
+        static_cast<hal::u16>(p_payload[0] | (p_payload[1] << 8));
+      p_context.stream.subscribe(
+        *p_context.requester, period_ms, p_payload[2] != 0);
+
+      std::array<hal::byte, 4> payload{ p_payload[0], p_payload[1] };
+      payload[2] = p_payload[2];
+      payload[3] =
+        std::accumulate(payload.begin(), payload.end() - 1, hal::byte{ 0 });
+      return reply(payload);
+    }
+    case 's': {  // Beacon reports and camera block in one response
+      auto const high_sweep = scanner.latest(irb_freq::high);
+      auto const low_sweep = scanner.latest(irb_freq::low);
+      auto const& camera = p_context.camera.latest().block;
+
+      auto const high = e10::protocol::to_bytes(
+        make_beacon_report(irb_freq::high, high_sweep.samples));
+      auto const low = e10::protocol::to_bytes(
+        make_beacon_report(irb_freq::low, low_sweep.samples));
+
+      std::array<hal::byte, sizeof(e10::protocol::snapshot)> payload{};
+      auto cursor = std::ranges::copy(high, payload.begin()).out;
+      cursor = std::ranges::copy(low, cursor).out;
+      // Drop the camera block's own checksum, the snapshot has one of its own
+      std::copy(camera.begin(), camera.end() - 1, cursor);
+      payload.back() =
+        std::accumulate(payload.begin(), payload.end() - 1, hal::byte{ 0 });
+      return reply(payload);
+    }
+    default:
+      e10::log<log_level::warning>(
+        console, "Unknown read 0x%02X \n", p_command);
+      return std::nullopt;
+  }
+}
+
+// Sweeps completed on both frequencies, grows whenever a sweep is published
+hal::u32 total_sweeps(e10::diode_scanner const& p_scanner)
 {
-  using namespace std::chrono_literals;
-
-  hal::output_pin& counter_reset = p_args.counter_reset;
-  hal::output_pin& counter_clock = p_args.counter_clock;
-  hal::adc& intensity = p_args.intensity;
-  hal::adc& reference = p_args.reference;
-  hal::steady_clock& clock = p_args.clock;
-
-  std::array<hal::u8, 8> samples{};
-
-  // Sample the voltage divider's voltage (max expected voltage from the sensor)
-  auto const reference_ratio = reference.read();
-
-  // Reset IRB hardware counter used to multiplex/select the photo diode to
-  // sample
-  counter_reset.level(true);
-  // Wait to allow reset to take hold
-  hal::delay(clock, 10us);
-  // Clear counter reset, photo-diode 0 should be accumulating charge
-  counter_reset.level(false);
-
-  for (auto& value : samples) {
-    counter_clock.level(true);
-    hal::delay(clock, 3ms);
-    // Increment the counter to the next photo-diode
-    counter_clock.level(false);
-    hal::delay(clock, 5ms);
-    // Sample the analog value
-    auto const reading = intensity.read();
-    // Map float to u8 relative to the reference ratio
-    auto const mapped_reading =
-      hal::map(reading, { 0.0f, reference_ratio }, { 0.0f, 255.0f });
-    auto const clamped_value =
-      std::clamp(static_cast<int>(mapped_reading), 0, 255);
-    value = static_cast<hal::u8>(clamped_value);
+  return p_scanner.sweeps_completed(irb_freq::low) +
+         p_scanner.sweeps_completed(irb_freq::high);
+}
+
+bool snapshot_due(command_context const& p_context)
+{
+  // The RS485 link is half-duplex, a push must not talk over a request that
+  // is still arriving
+  if (p_context.rs485_reader->receiving()) {
+    return false;
   }
+  return p_context.stream.due(total_sweeps(p_context.scanner));
+}
+
+void push_snapshot(command_context& p_context,
+                   std::span<hal::byte> p_response,
+                   std::span<hal::byte> p_frame)
+{
+  auto& stream = p_context.stream;
+  auto const sequence = stream.pushed(total_sweeps(p_context.scanner));
 
-  counter_reset.level(true);
-  counter_clock.level(true);
+  auto const command = hal::value(e10::protocol::command::snapshot);
+  auto const snapshot = handle_command(p_context,
+                                       command,
+                                       {},
+                                       e10::protocol::latest_version,
+                                       false,
+                                       p_response);
+  auto const length = e10::protocol::encode_frame(sequence,
+                                                  command,
+                                                  snapshot->data(),
+                                                  snapshot->size(),
+                                                  p_frame.data());
+  send_response(*stream.port(), p_frame.first(length), p_context.console);
+}
 
-  return samples;
+void send_response(hal::serial& p_port,
+                   std::span<hal::byte const> p_data,
+                   hal::serial& p_console)
+{
+  try {
+    hal::write(p_port, p_data, hal::never_timeout());
+  } catch (hal::timed_out const&) {
+    e10::log<log_level::warning>(p_console, "Response transmit timed out\n");
+  }
 }
 
 std::array<hal::byte, 3> get_strongest_signal(
@@ -336,206 +1015,53 @@ std::array<hal::byte, 3> get_strongest_signal(
   return return_bytes;
 }
 
-bool camera_init(std::span<hal::byte> p_all_data_buffer,
-                 hal::i2c& p_i2c,
-                 hal::serial& p_console,
-                 hal::steady_clock& p_clock)
+e10::protocol::beacon_report make_beacon_report(
+  irb_freq p_freq,
+  std::array<hal::u8, 8> const& p_samples)
 {
-  using namespace std::chrono_literals;
-
-  constexpr std::array<hal::byte, 16> knock_bytes{
-    header1,      header2,
-    knock_cmd,    any_algo,
-    knock_length, 0x00,
-    0x00,         0x00,
-    0x00,         0x00,
-    0x00,         0x00,
-    0x00,         0x00,
-    0x00,         hal::byte(header1 + header2 + knock_length)
-  };
-  // get rid of any previous data hanging in buffer
-  flush_buffer(p_i2c, p_console);
-  // knock camera to handshake and get response
-  hal::write(p_i2c, camera_address, knock_bytes);
-  hal::delay(p_clock, 50ms);
-  std::span<hal::byte> ok_buffer = read_response_data(p_all_data_buffer, p_i2c);
-
-  hal::print(p_console, "Knock Response: ");
-  for (hal::byte i : ok_buffer) {
-    hal::print<64>(p_console, "0x%02X ", unsigned{ i });
-  }
-  hal::print(p_console, "\n");
+  e10::protocol::beacon_report report{};
 
-  if (ok_buffer[1] != result_ok) {
-    hal::print(p_console, "Camera knock not ok.\n");
-    return false;
-  }
-  return true;
-}
+  auto const strongest = std::ranges::max_element(p_samples);
+  report.peak =
+    static_cast<hal::u8>(std::distance(p_samples.begin(), strongest));
+  report.intensity = *strongest;
+  report.frequency = hal::value(p_freq);
 
-void flush_buffer(hal::i2c& p_i2c, hal::serial& p_console)
-{
-  // flush the camera i2c buffer 4 bytes at a time
-  bool empty = false;
-  std::array<hal::byte, 4> byte_empty = { false, false, false, false };
-
-  while (!empty) {
-    std::array<hal::byte, 4> data = hal::read<4>(p_i2c, camera_address);
-    // preemptively set empty to true, if 4 empty bytes in a row are found,
-    // buffer is likely empty
-    empty = true;
-    hal::print(p_console, "Buffer Flush: ");
-    for (size_t i = 0; i < data.size(); i++) {
-      hal::print<64>(p_console, "0x%02X ", unsigned{ data[i] });
-      if (data[i] == 0xFF) {
-        // empty byte found
-        byte_empty[i] = true;
-      }
+  for (std::size_t i = 0; i < p_samples.size(); i++) {
+    if (i == report.peak) {
+      continue;
     }
-    for (auto slot : byte_empty) {
-      if (slot == false) {
-        empty = false;
-      }
+    if (report.second_peak == report.no_diode ||
+        p_samples[i] > report.second_intensity) {
+      report.second_peak = static_cast<hal::u8>(i);
+      report.second_intensity = p_samples[i];
     }
-    hal::print(p_console, "\n");
-  }
-}
-
-std::span<hal::byte> read_response_data(std::span<hal::byte> p_all_data_buffer,
-                                        hal::i2c& p_i2c)
-{
-  using namespace std::literals;
-
-  hal::byte header = 0x00;
-  uint8_t read_attempts = 0;
-  hal::byte cmd = 0;
-  hal::byte algo = 0;
-
-  // error bytes to be sent in case of error, last byte is a variable to
-  // describe what error occurred
-  // 0x01 = header1 mismatch
-  // 0x02 = header2 mismatch
-  std::span<hal::byte> error_bytes = p_all_data_buffer.subspan(0, 3);
-  error_bytes[0] = 0xDE;
-  error_bytes[1] = 0xAD;
-
-  while (header != header1 && read_attempts < 32) {
-    header = hal::read<1>(p_i2c, camera_address).front();
-    read_attempts++;
-  }
-  if (header != header1) {
-    error_bytes[2] = 0x01;
-    return error_bytes;
-  }
-  read_attempts = 0;
-  while (header != header2 && read_attempts < 32) {
-    header = hal::read<1>(p_i2c, camera_address).front();
-    read_attempts++;
-  }
-  if (header != header2) {
-    error_bytes[2] = 0x02;
-    return error_bytes;
-  }
-  cmd = hal::read<1>(p_i2c, camera_address).front();
-  algo = hal::read<1>(p_i2c, camera_address).front();
-  uint8_t data_length = hal::read<1>(p_i2c, camera_address).front();
-
-  std::span<hal::byte> data_buffer =
-    p_all_data_buffer.subspan(0, data_length + 3);
-  data_buffer[0] = cmd;
-  // start calculating checksum
-  hal::byte calculated_checksum = header1 + header2 + cmd + algo + data_length;
-
-  for (uint8_t i = 0; i < data_length; i++) {
-    hal::byte read_byte = hal::read<1>(p_i2c, camera_address).front();
-    data_buffer[i + 1] = read_byte;
-    calculated_checksum += read_byte;
   }
 
-  // get checksum from camera
-  hal::byte received_check_sum = hal::read<1>(p_i2c, camera_address).front();
-  data_buffer[data_length + 1] = received_check_sum;
-  data_buffer[data_length + 2] = calculated_checksum;
-
-  if (received_check_sum != calculated_checksum) {
-    // checksum mismatch, send anyways but change cmd
-    data_buffer[0] += 0x10;
-  }
-
-  return data_buffer;
+  report.checksum = e10::protocol::checksum(report);
+  return report;
 }
 
-std::array<hal::byte, 9> get_camera_data(std::span<hal::byte> p_all_data_buffer,
-                                         hal::i2c& p_i2c,
-                                         hal::serial& p_console)
+std::array<hal::byte, 6> timing_response(e10::diode_timing const& p_timing,
+                                         bool p_calibrating)
 {
-  using namespace std::chrono_literals;
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
 
-  std::array<hal::byte, 9> return_bytes{ 0x00, 0x00, 0x00, 0x00, 0x00,
-                                         0x00, 0x00, 0x00, 0x00 };
+  auto const integration_us = static_cast<hal::u16>(
+    duration_cast<microseconds>(p_timing.integration).count());
+  auto const settle_us = static_cast<hal::u16>(
+    duration_cast<microseconds>(p_timing.settle).count());
 
-  constexpr std::array<hal::byte, 6> request_blocks_bytes{
-    header1, header2, request_blocks_cmd, any_algo, 0x00, 0x00
-  };
+  std::array<hal::byte, 6> return_bytes{};
+  return_bytes[0] = static_cast<hal::byte>(integration_us & 0xFF);
+  return_bytes[1] = static_cast<hal::byte>(integration_us >> 8);
+  return_bytes[2] = static_cast<hal::byte>(settle_us & 0xFF);
+  return_bytes[3] = static_cast<hal::byte>(settle_us >> 8);
+  return_bytes[4] = p_calibrating;
+  // Calculate checksum
+  return_bytes[5] = std::accumulate(
+    return_bytes.begin(), return_bytes.end() - 1, hal::byte{ 0 });
 
-  try {
-    // request and read back data
-    hal::write(p_i2c, camera_address, request_blocks_bytes);
-    bool flush_needed = false;
-
-    std::span<hal::byte> read_buffer =
-      read_response_data(p_all_data_buffer, p_i2c);
-    // check command of return info
-    if (read_buffer[0] == 0x1B || read_buffer[0] == 0x2B) {
-      std::span<hal::byte> block_data_buffer =
-        read_response_data(p_all_data_buffer, p_i2c);
-      if (block_data_buffer[0] == 0x1C) {
-        // process data
-        uint16_t x = (block_data_buffer[4] << 8) | block_data_buffer[3];
-        uint16_t y = (block_data_buffer[6] << 8) | block_data_buffer[5];
-        hal::print<64>(
-          p_console, "X: %u   Y: %u\n", unsigned{ x }, unsigned{ y });
-        hal::byte send_checksum = 0x00;
-        for (size_t i = 3; i < 11; i++) {
-          return_bytes[i - 3] = block_data_buffer[i];
-          send_checksum += block_data_buffer[i];
-        }
-        return_bytes[8] = send_checksum;
-      } else {
-        hal::print(p_console, "Unknown Response: ");
-        flush_needed = true;
-        for (hal::byte i : block_data_buffer) {
-          hal::print<64>(p_console, "0x%02X ", i);
-        }
-        hal::print(p_console, "\n");
-      }
-    } else {
-      if (read_buffer[0] == 0x1C) {
-        uint16_t x = (read_buffer[4] << 8) | read_buffer[3];
-        uint16_t y = (read_buffer[6] << 8) | read_buffer[5];
-        hal::print<64>(
-          p_console, "X: %u   Y: %u\n", unsigned{ x }, unsigned{ y });
-        hal::byte send_checksum = 0x00;
-        for (size_t i = 3; i < 11; i++) {
-          return_bytes[i - 3] = read_buffer[i];
-          send_checksum += read_buffer[i];
-        }
-        return_bytes[8] = send_checksum;
-      } else {
-        hal::print(p_console, "Unknown Response: ");
-        flush_needed = true;
-        for (hal::byte i : read_buffer) {
-          hal::print<64>(p_console, "0x%02X ", i);
-        }
-        hal::print(p_console, "\n");
-      }
-    }
-    if (flush_needed) {
-      flush_buffer(p_i2c, p_console);
-    }
-  } catch (...) {
-    hal::print(p_console, "NACK\n");
-    flush_buffer(p_i2c, p_console);
-  }
   return return_bytes;
 }
@@ -0,0 +1,109 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+
+#include <bearing.hpp>
+
+#include "check.hpp"
+
+namespace {
+using intensities = std::array<hal::u16, e10::diode_count>;
+constexpr hal::u16 step = e10::bearing::steps_per_diode;
+}  // namespace
+
+int main()
+{
+  using e10::test::expect;
+
+  e10::test::run("darkness has no bearing and no confidence", [] {
+    auto const result = e10::interpolate_bearing({});
+    expect(result.position == 0);
+    expect(result.confidence == 0);
+    expect(result.peak == 0);
+  });
+
+  e10::test::run("the vertex of the parabola through the peak", [] {
+    // 40000 - 4000 * (x - 3.25)^2 around a peak a quarter past diode 3
+    intensities const profile{
+      1000, 1000, 33750, 39750, 37750, 1000, 1000, 1000
+    };
+    auto const result = e10::interpolate_bearing(profile);
+    expect(result.peak == 3);
+    expect(result.position == 3 * step + step / 4);
+
+    // Mirrored, a quarter before diode 4
+    intensities const mirrored{
+      1000, 1000, 1000, 37750, 39750, 33750, 1000, 1000
+    };
+    expect(e10::interpolate_bearing(mirrored).position == 4 * step - step / 4);
+
+    // Equal neighbours put the bearing on the peak
+    intensities const centred{ 0, 0, 0, 20000, 40000, 20000, 0, 0 };
+    expect(e10::interpolate_bearing(centred).position == 4 * step);
+  });
+
+  e10::test::run("a peak on diode 0 or 7 uses its only neighbour", [] {
+    intensities const first{ 30000, 10000, 0, 0, 0, 0, 0, 0 };
+    auto const at_first = e10::interpolate_bearing(first);
+    expect(at_first.peak == 0);
+    expect(at_first.position == step / 4);
+
+    intensities const last{ 0, 0, 0, 0, 0, 0, 10000, 30000 };
+    auto const at_last = e10::interpolate_bearing(last);
+    expect(at_last.peak == 7);
+    expect(at_last.position == 7 * step - step / 4);
+
+    // Without a lit neighbour the bearing stays on the end diode
+    intensities const alone{ 0, 0, 0, 0, 0, 0, 0, 30000 };
+    expect(e10::interpolate_bearing(alone).position == 7 * step);
+  });
+
+  e10::test::run("a flat plateau is centred on its middle", [] {
+    intensities const pair{ 0, 0, 0, 30000, 30000, 0, 0, 0 };
+    expect(e10::interpolate_bearing(pair).position == 3 * step + step / 2);
+
+    intensities const triple{ 0, 0, 30000, 30000, 30000, 0, 0, 0 };
+    expect(e10::interpolate_bearing(triple).position == 3 * step);
+
+    intensities const at_end{ 0, 0, 0, 0, 0, 30000, 30000, 30000 };
+    expect(e10::interpolate_bearing(at_end).position == 6 * step);
+
+    // Every diode equally lit says nothing about the direction
+    intensities flat{};
+    flat.fill(20000);
+    auto const result = e10::interpolate_bearing(flat);
+    expect(result.position == 3 * step + step / 2);
+    expect(result.confidence == 0);
+  });
+
+  e10::test::run("confidence follows the prominence and strength", [] {
+    intensities const strong{ 0, 0, 0, 0, 65535, 0, 0, 0 };
+    expect(e10::interpolate_bearing(strong).confidence == 255);
+
+    // Same shape at an eighth of full scale is half as trusted
+    intensities const weak{ 0, 0, 0, 0, 8192, 0, 0, 0 };
+    auto const weak_confidence = e10::interpolate_bearing(weak).confidence;
+    expect(weak_confidence >= 127 && weak_confidence <= 128);
+
+    // Half of the peak everywhere else
+    intensities const hazy{
+      20000, 20000, 20000, 20000, 40000, 20000, 20000, 20000
+    };
+    auto const hazy_confidence = e10::interpolate_bearing(hazy).confidence;
+    expect(hazy_confidence >= 127 && hazy_confidence <= 128);
+  });
+
+  return e10::test::summary();
+}
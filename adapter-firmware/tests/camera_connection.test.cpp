@@ -0,0 +1,98 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <chrono>
+
+#include <camera_connection.hpp>
+
+#include "check.hpp"
+#include "fakes.hpp"
+
+int main()
+{
+  using namespace std::chrono_literals;
+  using e10::test::expect;
+  using step = e10::camera_connection::step;
+  using connection_t = e10::camera_connection;
+
+  e10::test::run("failed knocks back off exponentially", [] {
+    e10::test::fake_clock clock;
+    connection_t connection(clock);
+    expect(not connection.connected());
+    expect(connection.next_step() == step::send_knock);
+
+    auto backoff = std::chrono::milliseconds(connection_t::first_backoff);
+    for (int attempt = 0; attempt < 8; attempt++) {
+      connection.knock_sent();
+      expect(connection.next_step() == step::none);
+      clock.advance(connection_t::knock_wait);
+      expect(connection.next_step() == step::read_knock);
+      connection.knock_answered(false);
+
+      clock.advance(backoff - 1ms);
+      expect(connection.next_step() == step::none);
+      clock.advance(1ms);
+      expect(connection.next_step() == step::send_knock);
+      backoff = std::min(backoff * 2, connection_t::max_backoff);
+    }
+    expect(connection.attempts() == 8);
+    expect(connection.connects() == 0);
+  });
+
+  e10::test::run("a lost camera is knocked on right away", [] {
+    e10::test::fake_clock clock;
+    connection_t connection(clock);
+    connection.knock_sent();
+    clock.advance(connection_t::knock_wait);
+    connection.knock_answered(true);
+    expect(connection.connected() && connection.ready());
+    expect(connection.next_step() == step::none);
+
+    connection.lost();
+    expect(not connection.connected());
+    expect(connection.next_step() == step::send_knock);
+  });
+
+  e10::test::run("an algorithm change is answered without blocking", [] {
+    e10::test::fake_clock clock;
+    connection_t connection(clock);
+
+    // Requested while disconnected, sent once connected
+    connection.change_algorithm();
+    expect(connection.next_step() == step::send_knock);
+    connection.knock_sent();
+    clock.advance(connection_t::knock_wait);
+    connection.knock_answered(true);
+    expect(not connection.ready());
+    expect(connection.next_step() == step::send_algorithm);
+
+    connection.algorithm_sent();
+    expect(connection.connected() && not connection.ready());
+    clock.advance(connection_t::algorithm_wait - 1ms);
+    expect(connection.next_step() == step::none);
+    clock.advance(1ms);
+    expect(connection.next_step() == step::read_algorithm);
+
+    // A second change asked for while waiting is sent after the answer
+    connection.change_algorithm();
+    connection.algorithm_answered();
+    expect(connection.next_step() == step::send_algorithm);
+    connection.cancel_algorithm_change();
+    expect(connection.ready());
+    expect(connection.next_step() == step::none);
+  });
+
+  return e10::test::summary();
+}
@@ -0,0 +1,248 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <span>
+
+#include <camera_connection.hpp>
+#include <camera_link.hpp>
+#include <camera_poller.hpp>
+#include <camera_service.hpp>
+#include <huskylens.hpp>
+#include <platforms/host_camera.hpp>
+
+#include "check.hpp"
+#include "fakes.hpp"
+
+namespace {
+using namespace std::chrono_literals;
+using e10::test::expect;
+namespace huskylens = e10::huskylens;
+
+/// Time the 100kHz bus takes per byte, address included, 8 bits and an ACK
+constexpr auto byte_time = 90us;
+/// Longest a main loop step may spend on the camera while it is unplugged
+constexpr auto unplugged_step_bound = 1ms;
+
+/**
+ * @brief Camera bus that moves the clock forward by the time every transaction
+ * would take on the wire
+ *
+ * A device that does not acknowledge its address costs the address byte.
+ */
+class timed_i2c : public hal::i2c
+{
+public:
+  timed_i2c(hal::i2c& p_i2c, e10::test::fake_clock& p_clock)
+    : m_i2c(&p_i2c)
+    , m_clock(&p_clock)
+  {
+  }
+
+  /// Transactions started since construction
+  hal::u32 transactions = 0;
+
+private:
+  void driver_configure(settings const& p_settings) override
+  {
+    m_i2c->configure(p_settings);
+  }
+
+  void driver_transaction(
+    hal::byte p_address,
+    std::span<hal::byte const> p_data_out,
+    std::span<hal::byte> p_data_in,
+    hal::function_ref<hal::timeout_function> p_timeout) override
+  {
+    transactions++;
+    m_clock->advance(byte_time);
+    m_i2c->transaction(p_address, p_data_out, p_data_in, p_timeout);
+    m_clock->advance(byte_time * (p_data_out.size() + p_data_in.size()));
+  }
+
+  hal::i2c* m_i2c;
+  e10::test::fake_clock* m_clock;
+};
+
+/// Camera, its connection and its cache, wired like the firmware's main loop
+struct camera_rig
+{
+  e10::test::fake_clock clock{};
+  e10::test::fake_serial console{};
+  e10::host::simulated_camera camera{};
+  timed_i2c bus{ camera, clock };
+  e10::camera_link link{ bus, clock, huskylens::camera_address };
+  e10::camera_connection connection{ clock };
+  e10::camera_poller poller{ clock };
+  std::array<hal::byte, 256> buffer{};
+  e10::camera_service service{ { .link = link,
+                                 .poller = poller,
+                                 .connection = connection,
+                                 .console = console,
+                                 .buffer = buffer } };
+  /// Longest camera step taken by run_for()
+  hal::time_duration longest_step = 0ns;
+
+  /// Run the main loop's camera steps, idling 1ms whenever nothing is due
+  void run_for(hal::time_duration p_duration)
+  {
+    auto const end = clock.now() + ticks(p_duration);
+    while (clock.now() < end) {
+      auto const start = clock.now();
+      if (not service.step()) {
+        clock.advance(1ms);
+        continue;
+      }
+      longest_step =
+        std::max(longest_step, hal::time_duration(clock.now() - start));
+    }
+  }
+
+  /// Run until the camera is connected, at most p_limit
+  bool connect_within(hal::time_duration p_limit)
+  {
+    auto const end = clock.now() + ticks(p_limit);
+    while (clock.now() < end && not connection.ready()) {
+      run_for(1ms);
+    }
+    return connection.ready();
+  }
+
+  static hal::u64 ticks(hal::time_duration p_duration)
+  {
+    return static_cast<hal::u64>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(p_duration)
+        .count());
+  }
+};
+}  // namespace
+
+int main()
+{
+  e10::test::run("invalidate forgets every algorithm's result", [] {
+    e10::test::fake_clock clock;
+    e10::camera_poller poller(clock);
+    poller.store({ .object_count = 1 });
+    poller.select(huskylens::obj_tracking_algorithm);
+    poller.store({ .object_count = 2 });
+    clock.advance(10ms);
+    expect(not poller.due());
+
+    poller.invalidate();
+    expect(poller.due());
+    expect(not poller.latest().valid && poller.latest().object_count == 0);
+    expect(poller.age_ms() == 0xFFFF);
+    poller.select(huskylens::any_algo);
+    expect(not poller.latest().valid && poller.age_ms() == 0xFFFF);
+  });
+
+  e10::test::run("a failed read does not refresh the cache", [] {
+    camera_rig rig;
+    rig.camera.add_object({ .command = huskylens::block_response,
+                            .id = 1,
+                            .geometry = { 160, 120, 20, 30 } });
+    expect(rig.connect_within(100ms));
+    rig.run_for(1ms);
+    expect(rig.poller.latest().valid && rig.poller.latest().object_count == 1);
+
+    rig.camera.plug(false);
+    auto const reads = rig.poller.reads();
+    expect(not rig.service.read().has_value());
+    expect(not rig.connection.connected());
+
+    // The poll the main loop makes after the loss stores nothing
+    rig.service.poll();
+    expect(rig.poller.reads() == reads);
+    expect(not rig.poller.latest().valid);
+    expect(rig.poller.latest().object_count == 0);
+    expect(rig.poller.age_ms() == 0xFFFF);
+
+    rig.run_for(e10::camera_connection::max_backoff);
+    expect(rig.poller.reads() == reads);
+    expect(rig.poller.age_ms() == 0xFFFF);
+  });
+
+  e10::test::run("an unplugged camera reconnects and reports again", [] {
+    camera_rig rig;
+    rig.camera.add_object({ .command = huskylens::block_response,
+                            .id = 1,
+                            .geometry = { 160, 120, 20, 30 } });
+    expect(rig.connect_within(100ms));
+    rig.run_for(1ms);
+    expect(rig.poller.latest().valid && rig.poller.latest().object_count == 1);
+
+    // The cached result must not outlive the camera
+    rig.camera.plug(false);
+    rig.run_for(e10::camera_poller::frame_period);
+    expect(not rig.connection.connected());
+    expect(not rig.poller.latest().valid);
+    expect(rig.poller.latest().object_count == 0);
+    expect(rig.poller.age_ms() == 0xFFFF);
+
+    rig.camera.plug(true);
+    expect(rig.connect_within(e10::camera_connection::max_backoff +
+                              e10::camera_connection::knock_wait));
+    expect(rig.connection.connects() == 2);
+
+    rig.run_for(1ms);
+    auto const& frame = rig.poller.latest();
+    expect(frame.valid && frame.object_count == 1);
+    expect(frame.objects[0].id == 1);
+    expect(frame.objects[0].kind == e10::protocol::camera_object::block);
+    expect(rig.poller.age_ms() <= 1);
+  });
+
+  e10::test::run("camera steps stay short while the camera is away", [] {
+    camera_rig rig;
+    for (hal::byte id = 1; id <= e10::protocol::max_camera_objects; id++) {
+      rig.camera.add_object({ .command = huskylens::block_response,
+                              .id = id,
+                              .geometry = { 160, 120, 20, 30 } });
+    }
+    expect(rig.connect_within(100ms));
+    // A connected camera costs a full read of every object, for reference
+    rig.run_for(1s);
+    auto const connected_step = rig.longest_step;
+
+    // Unplugged for a minute, every step is a single unanswered transaction
+    // and the attempts back off to one every max_backoff
+    rig.camera.plug(false);
+    rig.longest_step = 0ns;
+    auto const transactions = rig.bus.transactions;
+    rig.run_for(60s);
+    auto const unplugged_step = rig.longest_step;
+    auto const attempts = rig.bus.transactions - transactions;
+    expect(unplugged_step <= unplugged_step_bound);
+    expect(attempts <= 60s / e10::camera_connection::max_backoff + 8);
+
+    rig.camera.plug(true);
+    expect(rig.connect_within(e10::camera_connection::max_backoff +
+                              e10::camera_connection::knock_wait));
+
+    using std::chrono::microseconds;
+    std::printf(
+      "  longest camera step: connected %lldus, unplugged %lldus, "
+      "%u attempts in 60s\n",
+      static_cast<long long>(
+        std::chrono::duration_cast<microseconds>(connected_step).count()),
+      static_cast<long long>(
+        std::chrono::duration_cast<microseconds>(unplugged_step).count()),
+      static_cast<unsigned>(attempts));
+  });
+
+  return e10::test::summary();
+}
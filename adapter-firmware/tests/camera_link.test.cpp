@@ -0,0 +1,231 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <chrono>
+#include <deque>
+#include <vector>
+
+#include <camera_link.hpp>
+#include <huskylens.hpp>
+
+#include "check.hpp"
+#include "fakes.hpp"
+
+namespace {
+using namespace std::chrono_literals;
+using e10::test::expect;
+using outcome = e10::camera_link::outcome;
+namespace huskylens = e10::huskylens;
+
+/**
+ * @brief Camera that sends a fixed byte stream, then idles with 0xFF
+ *
+ */
+class streaming_camera : public hal::i2c
+{
+public:
+  /**
+   * @brief Construct a new streaming camera
+   *
+   * @param p_clock - clock moved forward by every transaction
+   */
+  explicit streaming_camera(e10::test::fake_clock& p_clock)
+    : m_clock(&p_clock)
+  {
+  }
+
+  /// Queue bytes to send
+  void send(std::vector<hal::byte> const& p_bytes)
+  {
+    m_stream.insert(m_stream.end(), p_bytes.begin(), p_bytes.end());
+  }
+
+  /// Queue junk bytes that are neither a header nor idle
+  void send_junk(std::size_t p_count)
+  {
+    m_stream.insert(m_stream.end(), p_count, 0x42);
+  }
+
+  /// Time every transaction takes
+  hal::time_duration transaction_time = 0ms;
+
+private:
+  void driver_configure(settings const&) override
+  {
+  }
+
+  void driver_transaction(
+    hal::byte,
+    std::span<hal::byte const>,
+    std::span<hal::byte> p_data_in,
+    hal::function_ref<hal::timeout_function>) override
+  {
+    m_clock->advance(transaction_time);
+    for (auto& byte : p_data_in) {
+      if (m_stream.empty()) {
+        byte = 0xFF;
+        continue;
+      }
+      byte = m_stream.front();
+      m_stream.pop_front();
+    }
+  }
+
+  e10::test::fake_clock* m_clock;
+  std::deque<hal::byte> m_stream{};
+};
+
+/**
+ * @brief Encode a camera response
+ *
+ * @param p_command - response command
+ * @param p_payload - payload bytes
+ * @return std::vector<hal::byte> - header, command, algorithm 0, length,
+ * payload and checksum
+ */
+std::vector<hal::byte> response(hal::byte p_command,
+                                std::vector<hal::byte> const& p_payload)
+{
+  std::vector<hal::byte> bytes{ huskylens::header1,
+                                huskylens::header2,
+                                p_command,
+                                huskylens::any_algo,
+                                static_cast<hal::byte>(p_payload.size()) };
+  bytes.insert(bytes.end(), p_payload.begin(), p_payload.end());
+  hal::byte checksum = 0;
+  for (auto const byte : bytes) {
+    checksum += byte;
+  }
+  bytes.push_back(checksum);
+  return bytes;
+}
+
+/// Knock answer as the camera sends it
+std::vector<hal::byte> const ok_response =
+  response(huskylens::knock_cmd, { huskylens::result_ok });
+
+/// Camera and the link reading it
+struct link_rig
+{
+  e10::test::fake_clock clock{};
+  e10::test::fake_serial console{};
+  streaming_camera camera{ clock };
+  e10::camera_link link{ camera, clock, huskylens::camera_address };
+  std::array<hal::byte, 64> buffer{};
+};
+}  // namespace
+
+int main()
+{
+  e10::test::run("a resync keeps the header it finds", [] {
+    link_rig rig;
+    rig.camera.send_junk(21);
+    rig.camera.send(ok_response);
+
+    expect(rig.link.resync() == outcome::found_header);
+    auto const response = huskylens::read_response_data(rig.buffer, rig.link);
+    expect(response.size() == 4 && response[0] == 0x00 &&
+           response[2] == response[3]);
+
+    auto const& stats = rig.link.stats();
+    expect(stats.resyncs == 1 && stats.recovered == 1);
+    expect(stats.bytes_discarded == 21);
+    expect(stats.budget_exhausted == 0);
+  });
+
+  e10::test::run("a header split across chunks is still found", [] {
+    link_rig rig;
+    // The first header byte is the last byte of the first chunk
+    rig.camera.send_junk(e10::camera_link::chunk_size - 1);
+    rig.camera.send(ok_response);
+
+    expect(rig.link.resync() == outcome::found_header);
+    auto const response = huskylens::read_response_data(rig.buffer, rig.link);
+    expect(response.size() == 4 && response[2] == response[3]);
+  });
+
+  e10::test::run("a resync stops after 256 bytes", [] {
+    link_rig rig;
+    rig.camera.send_junk(1000);
+    rig.camera.send(ok_response);
+
+    expect(rig.link.resync() == outcome::budget_exhausted);
+    expect(rig.link.stats().bytes_discarded ==
+           e10::camera_link::byte_budget);
+    expect(rig.link.stats().budget_exhausted == 1);
+
+    // Drains are held to the same budget
+    expect(rig.link.drain() == outcome::budget_exhausted);
+    expect(rig.link.stats().bytes_discarded ==
+           2 * e10::camera_link::byte_budget);
+  });
+
+  e10::test::run("a resync stops after 10 ms", [] {
+    link_rig rig;
+    rig.camera.transaction_time = 1ms;
+    rig.camera.send_junk(1000);
+
+    auto const start = rig.clock.now();
+    expect(rig.link.resync() == outcome::budget_exhausted);
+    auto const elapsed = std::chrono::nanoseconds(rig.clock.now() - start);
+    expect(elapsed == e10::camera_link::time_budget);
+    expect(rig.link.stats().bytes_discarded ==
+           10 * e10::camera_link::chunk_size);
+  });
+
+  e10::test::run("a drain ends once the camera is idle", [] {
+    link_rig rig;
+    rig.camera.send(ok_response);
+    rig.camera.send_junk(30);
+
+    expect(rig.link.drain() == outcome::idle);
+    expect(rig.link.stats().drains == 1);
+    expect(rig.link.resync() == outcome::idle);
+    expect(rig.link.stats().recovered == 0);
+  });
+
+  e10::test::run("a truncated response is flagged, not trusted", [] {
+    link_rig rig;
+    // The camera stops sending after the first payload byte of a block
+    auto truncated = response(huskylens::block_response,
+                              { 0x01, 0, 0x20, 0, 0x30, 0, 0, 0, 0, 0 });
+    truncated.resize(6);
+    rig.camera.send(truncated);
+
+    auto const response = huskylens::read_response_data(rig.buffer, rig.link);
+    // The 0xFF filler fails the checksum, which raises the command
+    expect(response[0] == huskylens::block_response + 0x10);
+    expect(rig.link.resync() == outcome::idle);
+  });
+
+  e10::test::run("a corrupted result resyncs to the next response", [] {
+    link_rig rig;
+    // One object announced, then a response of an unknown command and junk
+    // in front of it
+    rig.camera.send(response(0x1B, { 0x01 }));
+    rig.camera.send(response(0x77, {}));
+    rig.camera.send_junk(5);
+    rig.camera.send(response(huskylens::block_response,
+                             { 0x03, 0, 0x20, 0, 0x30, 0, 0, 0, 0, 0 }));
+
+    auto const frame = huskylens::get_camera_data(
+      rig.buffer, rig.link, rig.console, huskylens::any_algo);
+    expect(frame.object_count == 1 && frame.objects[0].id == 0x03);
+    expect(frame.block[0] == 0x20 && frame.block[2] == 0x30);
+    expect(rig.link.stats().recovered == 1);
+  });
+
+  return e10::test::summary();
+}
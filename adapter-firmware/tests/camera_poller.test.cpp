@@ -0,0 +1,105 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+
+#include <camera_poller.hpp>
+
+#include "check.hpp"
+#include "fakes.hpp"
+
+int main()
+{
+  using namespace std::chrono_literals;
+  using e10::test::expect;
+  using poller_t = e10::camera_poller;
+
+  e10::test::run("reads are spaced by the camera's frame period", [] {
+    e10::test::fake_clock clock;
+    poller_t poller(clock);
+    expect(poller.due());
+    poller.store({});
+    expect(poller.reads() == 1);
+    clock.advance(poller_t::frame_period - 1ms);
+    expect(not poller.due());
+    clock.advance(1ms);
+    expect(poller.due());
+  });
+
+  e10::test::run("the age grows from the read and saturates", [] {
+    e10::test::fake_clock clock;
+    poller_t poller(clock);
+    expect(not poller.latest().valid);
+    expect(poller.age_ms() == 0xFFFF);
+
+    clock.advance(5ms);
+    poller.store({ .object_count = 1 });
+    expect(poller.latest().valid && poller.latest().object_count == 1);
+    expect(poller.latest().captured == clock.now());
+    expect(poller.age_ms() == 0);
+    clock.advance(250ms);
+    expect(poller.age_ms() == 250);
+    clock.advance(std::chrono::seconds(70));
+    expect(poller.age_ms() == 0xFFFF);
+
+    // A new read makes the cache fresh again
+    poller.store({});
+    expect(poller.age_ms() == 0);
+  });
+
+  e10::test::run("a result never answers for another algorithm", [] {
+    e10::test::fake_clock clock;
+    poller_t poller(clock);
+    poller.store({ .object_count = 1 });
+    clock.advance(10ms);
+
+    poller.select(3);
+    expect(poller.algorithm() == 3);
+    // The new algorithm is read right away and has nothing cached yet
+    expect(poller.due());
+    expect(not poller.latest().valid && poller.age_ms() == 0xFFFF);
+    poller.store({ .object_count = 2 });
+
+    // Switching back finds the first result, with its original age
+    poller.select(0);
+    expect(poller.latest().object_count == 1);
+    expect(poller.age_ms() == 10);
+  });
+
+  e10::test::run("the least recently selected slot is reused", [] {
+    e10::test::fake_clock clock;
+    poller_t poller(clock);
+    // Algorithm 0 holds the first slot, fill the others
+    for (hal::byte algorithm = 1; algorithm < poller_t::algorithm_slots;
+         algorithm++) {
+      poller.select(algorithm);
+      poller.store({ .object_count = algorithm });
+    }
+    poller.select(0);
+    poller.store({ .object_count = 7 });
+
+    // Algorithm 1 was selected longest ago and gives up its slot
+    poller.select(5);
+    expect(not poller.latest().valid);
+    poller.select(1);
+    expect(not poller.latest().valid);
+    poller.select(0);
+    expect(poller.latest().object_count == 7);
+    // Algorithm 2 was next, 1 took its slot
+    poller.select(3);
+    expect(poller.latest().object_count == 3);
+  });
+
+  return e10::test::summary();
+}
@@ -0,0 +1,92 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdio>
+#include <exception>
+#include <source_location>
+#include <string_view>
+
+namespace e10::test {
+/**
+ * @brief Number of failed expectations in this test executable
+ *
+ * @return int& - failure count
+ */
+inline int& failures()
+{
+  static int count = 0;
+  return count;
+}
+
+/**
+ * @brief Check a condition, printing where it failed if it does not hold
+ *
+ * @param p_condition - condition that must hold
+ * @param p_location - call site, filled in by the compiler
+ * @return bool - p_condition, so a test can stop early on a failure
+ */
+inline bool expect(
+  bool p_condition,
+  std::source_location p_location = std::source_location::current())
+{
+  if (not p_condition) {
+    failures()++;
+    std::fprintf(stderr,
+                 "  FAILED %s:%u\n",
+                 p_location.file_name(),
+                 static_cast<unsigned>(p_location.line()));
+  }
+  return p_condition;
+}
+
+/**
+ * @brief Run one test case
+ *
+ * An exception escaping the test case counts as a failure.
+ *
+ * @param p_name - name printed with the result
+ * @param p_body - test case
+ */
+template<typename Body>
+void run(std::string_view p_name, Body&& p_body)
+{
+  auto const before = failures();
+  try {
+    p_body();
+  } catch (std::exception const& p_error) {
+    failures()++;
+    std::fprintf(stderr, "  FAILED exception: %s\n", p_error.what());
+  } catch (...) {
+    failures()++;
+    std::fprintf(stderr, "  FAILED unknown exception\n");
+  }
+  std::fprintf(stderr,
+               "%s %.*s\n",
+               failures() == before ? "ok  " : "FAIL",
+               static_cast<int>(p_name.size()),
+               p_name.data());
+}
+
+/**
+ * @brief Exit code for the test executable
+ *
+ * @return int - 0 if every expectation held
+ */
+inline int summary()
+{
+  return failures() == 0 ? 0 : 1;
+}
+}  // namespace e10::test
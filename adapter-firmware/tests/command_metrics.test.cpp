@@ -0,0 +1,103 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <cstdint>
+
+#include <command_metrics.hpp>
+
+#include "check.hpp"
+
+int main()
+{
+  using e10::test::expect;
+  using histogram = e10::latency_histogram;
+  using metrics = e10::command_metrics;
+
+  e10::test::run("log2 bucket edges", [] {
+    static_assert(histogram::bucket(0) == 0);
+    expect(histogram::bucket(0) == 0);
+    expect(histogram::bucket(1) == 0);
+    expect(histogram::bucket(2) == 1);
+    expect(histogram::bucket(3) == 1);
+    expect(histogram::bucket(4) == 2);
+    expect(histogram::bucket(1023) == 9);
+    expect(histogram::bucket(1024) == 10);
+    expect(histogram::bucket(32'767) == 14);
+    expect(histogram::bucket(32'768) == 15);
+    expect(histogram::bucket(UINT32_MAX) == 15);
+  });
+
+  e10::test::run("record counts, buckets and the longest latency", [] {
+    histogram latencies;
+    expect(latencies.count() == 0);
+    expect(latencies.max() == 0);
+
+    latencies.record(0);
+    latencies.record(3);
+    latencies.record(2);
+    latencies.record(100'000);
+
+    expect(latencies.count() == 4);
+    expect(latencies.max() == 100'000);
+    expect(latencies.buckets()[0] == 1);
+    expect(latencies.buckets()[1] == 2);
+    expect(latencies.buckets()[15] == 1);
+  });
+
+  e10::test::run("commands get their own slot in first seen order", [] {
+    metrics tracked;
+    tracked.record('v', 10);
+    tracked.record('a', 20);
+    tracked.record('v', 30);
+
+    std::array<std::uint8_t, metrics::command_slots> commands{};
+    expect(tracked.commands(commands) == 2);
+    expect(commands[0] == 'v');
+    expect(commands[1] == 'a');
+    expect(tracked.find('v')->count() == 2);
+    expect(tracked.find('v')->max() == 30);
+    expect(tracked.find('a')->count() == 1);
+    expect(tracked.find('x') == nullptr);
+    expect(tracked.find(metrics::overflow_command) == nullptr);
+  });
+
+  e10::test::run("commands beyond the last slot share the overflow", [] {
+    metrics tracked;
+    constexpr auto dedicated = metrics::command_slots - 1;
+    for (std::size_t i = 0; i < dedicated; i++) {
+      tracked.record(static_cast<std::uint8_t>('a' + i), 1);
+    }
+
+    std::array<std::uint8_t, metrics::command_slots> commands{};
+    expect(tracked.commands(commands) == dedicated);
+    expect(tracked.find(metrics::overflow_command) == nullptr);
+
+    tracked.record('A', 5);
+    tracked.record('B', 7000);
+    tracked.record('a', 2);
+
+    expect(tracked.commands(commands) == metrics::command_slots);
+    expect(commands.back() == metrics::overflow_command);
+    expect(tracked.find('A') == nullptr);
+    auto const* overflow = tracked.find(metrics::overflow_command);
+    if (expect(overflow != nullptr)) {
+      expect(overflow->count() == 2);
+      expect(overflow->max() == 7000);
+    }
+    expect(tracked.find('a')->count() == 2);
+  });
+
+  return e10::test::summary();
+}
@@ -0,0 +1,166 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <chrono>
+
+#include <command_queue.hpp>
+#include <e10_protocol.hpp>
+
+#include "check.hpp"
+#include "fakes.hpp"
+
+namespace {
+using namespace std::chrono_literals;
+using e10::test::expect;
+
+/// Longer than the reader waits for the rest of a request
+constexpr auto past_timeout = e10::command_reader::payload_timeout + 1ms;
+
+/// Receive bytes and poll them into the queue
+void send(e10::test::fake_serial& p_serial,
+          e10::command_reader& p_reader,
+          e10::command_queue<4>& p_queue,
+          std::span<hal::byte const> p_bytes)
+{
+  p_serial.receive(p_bytes);
+  p_reader.poll(p_serial, p_queue);
+}
+}  // namespace
+
+int main()
+{
+  e10::test::run("unframed commands and payloads", [] {
+    e10::test::fake_clock clock;
+    e10::test::fake_serial serial;
+    e10::command_reader reader(clock, false);
+    e10::command_queue<4> queue;
+
+    // 'v' has no payload, 'p' has one byte followed by its checksum
+    std::array<hal::byte, 4> const bytes{ 'v', 'p', 1, 1 };
+    send(serial, reader, queue, bytes);
+
+    e10::received_command received;
+    expect(queue.pop(received) && received.request.command == 'v');
+    expect(queue.pop(received) && received.request.command == 'p' &&
+           received.request.length == 1 && received.request.payload[0] == 1 &&
+           not received.framed);
+    expect(queue.empty());
+  });
+
+  e10::test::run("late or mismatched payloads are rejected", [] {
+    e10::test::fake_clock clock;
+    e10::test::fake_serial serial;
+    e10::command_reader reader(clock, false);
+    e10::command_queue<4> queue;
+
+    std::array<hal::byte, 1> const command{ 'p' };
+    send(serial, reader, queue, command);
+    clock.advance(past_timeout);
+    std::array<hal::byte, 1> const version{ 'v' };
+    send(serial, reader, queue, version);
+
+    e10::received_command received;
+    expect(reader.rejected() == 1);
+    expect(queue.pop(received) && received.request.command == 'v');
+
+    std::array<hal::byte, 3> const bad_checksum{ 'p', 1, 2 };
+    send(serial, reader, queue, bad_checksum);
+    expect(reader.rejected() == 2);
+    expect(reader.checksum_errors() == 1);
+    expect(queue.empty());
+  });
+
+  e10::test::run("the console waits for payloads typed by hand", [] {
+    e10::test::fake_clock clock;
+    e10::test::fake_serial serial;
+    e10::command_reader console(clock, true);
+    e10::command_queue<4> queue;
+
+    // 'A' then its algorithm byte and checksum, a second apart
+    std::array<hal::byte, 3> const typed{ 'A', 1, 1 };
+    for (std::size_t i = 0; i < typed.size(); i++) {
+      send(serial, console, queue, std::span(typed).subspan(i, 1));
+      clock.advance(1s);
+    }
+    e10::received_command received;
+    expect(queue.pop(received) && received.request.command == 'A' &&
+           received.console && received.request.payload[0] == 1);
+    expect(console.rejected() == 0);
+
+    // An abandoned payload still gives way to the next command
+    std::array<hal::byte, 1> const command{ 'A' };
+    send(serial, console, queue, command);
+    clock.advance(e10::command_reader::console_payload_timeout + 1ms);
+    std::array<hal::byte, 1> const version{ 'v' };
+    send(serial, console, queue, version);
+    expect(console.rejected() == 1);
+    expect(queue.pop(received) && received.request.command == 'v');
+  });
+
+  e10::test::run("a stray sync byte does not swallow later commands", [] {
+    e10::test::fake_clock clock;
+    e10::test::fake_serial serial;
+    e10::command_reader reader(clock, false);
+    e10::command_queue<4> queue;
+
+    std::array<hal::byte, 1> const stray{ e10::protocol::frame_sync };
+    send(serial, reader, queue, stray);
+    expect(reader.frames().in_frame());
+
+    clock.advance(past_timeout);
+    std::array<hal::byte, 1> const version{ 'v' };
+    send(serial, reader, queue, version);
+
+    e10::received_command received;
+    expect(not reader.frames().in_frame());
+    expect(reader.frames().discarded() == 1);
+    expect(queue.pop(received) && received.request.command == 'v' &&
+           not received.framed);
+  });
+
+  e10::test::run("a frame arriving slowly is still accepted", [] {
+    e10::test::fake_clock clock;
+    e10::test::fake_serial serial;
+    e10::command_reader reader(clock, false);
+    e10::command_queue<4> queue;
+
+    std::array<hal::byte, e10::protocol::max_frame_size> frame{};
+    hal::byte const command = 'v';
+    auto const length =
+      e10::protocol::encode_frame(7, command, nullptr, 0, frame.data());
+    // Every byte arrives just inside the timeout of the byte before it
+    for (std::size_t i = 0; i < length; i++) {
+      send(serial, reader, queue, std::span(frame).subspan(i, 1));
+      clock.advance(e10::command_reader::payload_timeout - 1ms);
+    }
+
+    e10::received_command received;
+    expect(queue.pop(received) && received.framed &&
+           received.request.sequence == 7 && received.request.command == 'v');
+  });
+
+  e10::test::run("a full queue counts dropped commands", [] {
+    e10::test::fake_clock clock;
+    e10::test::fake_serial serial;
+    e10::command_reader reader(clock, false);
+    e10::command_queue<4> queue;
+
+    std::array<hal::byte, 6> const versions{ 'v', 'v', 'v', 'v', 'v', 'v' };
+    send(serial, reader, queue, versions);
+    expect(queue.dropped() == 2);
+  });
+
+  return e10::test::summary();
+}
@@ -0,0 +1,281 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Every log level is compiled in, so trace messages reach the console
+#define E10_LOG_LEVEL 0
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+#include <libhal/timeout.hpp>
+
+#include <log.hpp>
+
+#include "check.hpp"
+#include "fakes.hpp"
+
+namespace {
+using namespace std::chrono_literals;
+using e10::test::expect;
+using e10::log_level;
+
+/**
+ * @brief UART transmitter with a data register and a shift register, sending
+ * at a fixed baud rate on a fake clock
+ *
+ * A byte is taken while the data register is empty. If it is full, a blocking
+ * transmitter waits for it to empty, like the libhal UART drivers, while a
+ * non-blocking one returns the bytes taken so far, like the firmware's
+ * console ports.
+ */
+class paced_serial : public hal::serial
+{
+public:
+  /// Time one byte takes at 115200 baud, 10 bits per byte
+  static constexpr hal::u64 byte_ticks = 86'806;
+
+  paced_serial(e10::test::fake_clock& p_clock, bool p_blocking)
+    : m_clock(&p_clock)
+    , m_blocking(p_blocking)
+  {
+  }
+
+  /// Bytes taken since construction
+  std::size_t sent = 0;
+
+private:
+  void driver_configure(settings const&) override
+  {
+  }
+
+  write_t driver_write(std::span<hal::byte const> p_data) override
+  {
+    std::size_t taken = 0;
+    for (; taken < p_data.size(); taken++) {
+      // The shift register holds one byte, the data register the next
+      auto const now = m_clock->now();
+      if (m_idle_at > now + byte_ticks) {
+        if (not m_blocking) {
+          break;
+        }
+        auto const wait = m_idle_at - byte_ticks - now;
+        m_clock->advance(std::chrono::nanoseconds(wait));
+      }
+      m_idle_at = std::max(m_idle_at, m_clock->now()) + byte_ticks;
+    }
+    sent += taken;
+    return { .data = p_data.first(taken) };
+  }
+
+  read_t driver_read(std::span<hal::byte> p_data) override
+  {
+    return { .data = p_data.first(0), .available = 0, .capacity = 0 };
+  }
+
+  void driver_flush() override
+  {
+  }
+
+  e10::test::fake_clock* m_clock;
+  hal::u64 m_idle_at = 0;
+  bool m_blocking;
+};
+
+/// Command latencies seen by a simulated main loop
+struct latency_report
+{
+  hal::u64 max = 0;
+  hal::u64 total = 0;
+  int commands = 0;
+  std::size_t logged = 0;
+};
+
+/**
+ * @brief Run the main loop's command handling and console drain
+ *
+ * A command arrives every 1.3ms and takes 50us to handle. When p_trace is
+ * set, every command and every idle pass log trace messages like the camera's
+ * byte dumps do. The console is drained whenever no command is waiting.
+ *
+ * @param p_trace - log at trace level, otherwise nothing is logged
+ * @param p_blocking - the console transmitter waits for room
+ * @return latency_report - time from each command's arrival to its answer
+ */
+latency_report run_commands(bool p_trace, bool p_blocking)
+{
+  constexpr hal::u64 arrival_ticks = 1'300'000;
+  constexpr auto handling = 50us;
+  e10::test::fake_clock clock;
+  paced_serial uart(clock, p_blocking);
+  e10::deferred_serial<1024> console(uart);
+  hal::u64 next_arrival = arrival_ticks;
+  latency_report report{};
+
+  while (report.commands < 500) {
+    if (clock.now() >= next_arrival) {
+      auto const arrival = next_arrival;
+      next_arrival += arrival_ticks;
+      clock.advance(handling);
+      if (p_trace) {
+        e10::log<log_level::trace, 128>(
+          console,
+          "Command 0x%02X, Response: 0x%02X 0x%02X 0x%02X 0x%02X\n",
+          0x73u,
+          0x12u,
+          0x34u,
+          0x56u,
+          0x78u);
+      }
+      auto const latency = clock.now() - arrival;
+      report.max = std::max(report.max, latency);
+      report.total += latency;
+      report.commands++;
+      continue;
+    }
+    if (console.drain() == 0) {
+      // Asleep until the next interrupt
+      clock.advance(10us);
+    }
+  }
+  report.logged = uart.sent;
+  return report;
+}
+
+void write(hal::serial& p_serial, std::string_view p_text)
+{
+  hal::write(p_serial,
+             std::span(reinterpret_cast<hal::byte const*>(p_text.data()),
+                       p_text.size()),
+             hal::never_timeout());
+}
+
+bool written(e10::test::fake_serial& p_port, std::string_view p_text)
+{
+  auto const bytes = p_port.take_written();
+  return std::string_view(reinterpret_cast<char const*>(bytes.data()),
+                          bytes.size()) == p_text;
+}
+}  // namespace
+
+int main()
+{
+  e10::test::run("writes wait for a drain", [] {
+    e10::test::fake_serial port;
+    e10::deferred_serial<64> deferred(port);
+    write(deferred, "0123456789abcdefghij");
+    expect(written(port, ""));
+    expect(not deferred.empty());
+
+    expect(deferred.drain() == e10::deferred_serial<64>::default_drain_size);
+    expect(written(port, "0123456789abcdef"));
+    expect(deferred.drain() == 4);
+    expect(written(port, "ghij"));
+    expect(deferred.drain() == 0);
+    expect(deferred.empty());
+  });
+
+  e10::test::run("data wrapping around the ring stays in order", [] {
+    e10::test::fake_serial port;
+    e10::deferred_serial<8> deferred(port);
+    write(deferred, "abcdef");
+    expect(deferred.drain() == 6);
+    expect(written(port, "abcdef"));
+
+    write(deferred, "ghijk");
+    // Up to the end of the ring first, the rest on the next drain
+    expect(deferred.drain() == 2);
+    expect(deferred.drain() == 3);
+    expect(written(port, "ghijk"));
+  });
+
+  e10::test::run("a write that does not fit is dropped whole", [] {
+    e10::test::fake_serial port;
+    e10::deferred_serial<8> deferred(port);
+    write(deferred, "12345");
+    write(deferred, "6789");
+    expect(deferred.dropped() == 4);
+    // Exactly filling the ring is fine
+    write(deferred, "abc");
+    expect(deferred.dropped() == 4);
+    write(deferred, "d");
+    expect(deferred.dropped() == 5);
+
+    deferred.drain(8);
+    expect(written(port, "12345abc"));
+    write(deferred, "6789");
+    deferred.drain(8);
+    expect(written(port, "6789"));
+    expect(deferred.dropped() == 5);
+  });
+
+  e10::test::run("reads and configuration pass straight through", [] {
+    e10::test::fake_serial port;
+    e10::deferred_serial<8> deferred(port);
+    std::array<hal::byte, 2> const received{ 'v', 'a' };
+    port.receive(received);
+
+    std::array<hal::byte, 4> buffer{};
+    auto const result = deferred.read(buffer);
+    expect(result.data.size() == 2 && buffer[0] == 'v' && buffer[1] == 'a');
+
+    deferred.configure({ .baud_rate = 230400 });
+    expect(port.baud_rate == 230400 && port.configures == 1);
+  });
+
+  e10::test::run("a drain only passes on what the port takes", [] {
+    e10::test::fake_clock clock;
+    paced_serial uart(clock, false);
+    e10::deferred_serial<64> deferred(uart);
+    write(deferred, "0123456789");
+
+    // The shift and data registers take two bytes, the rest waits
+    expect(deferred.drain() == 2);
+    expect(deferred.drain() == 0);
+    expect(clock.now() == 0);
+    clock.advance(std::chrono::nanoseconds(paced_serial::byte_ticks));
+    expect(deferred.drain() == 1);
+    clock.advance(1s);
+    expect(deferred.drain() == 2);
+    expect(deferred.drain() == 0);
+    expect(uart.sent == 5 && not deferred.empty());
+  });
+
+  e10::test::run("command latency does not depend on the log volume", [] {
+    auto const off = run_commands(false, false);
+    auto const trace = run_commands(true, false);
+    expect(off.logged == 0);
+    // The console was kept busy for most of the run
+    expect(trace.logged * paced_serial::byte_ticks > 500 * 1'000'000);
+    expect(trace.max == off.max);
+    expect(trace.total == off.total);
+
+    // Draining into a transmitter that waits delays commands arriving
+    // meanwhile, which the non-blocking drain avoids
+    auto const blocking = run_commands(true, true);
+    expect(blocking.max > off.max);
+
+    std::printf("  command latency: off %.1fus max, trace %.1fus max "
+                "(%zu B logged), blocking drain %.1fus max\n",
+                static_cast<float>(off.max) / 1e3f,
+                static_cast<float>(trace.max) / 1e3f,
+                trace.logged,
+                static_cast<float>(blocking.max) / 1e3f);
+  });
+
+  return e10::test::summary();
+}
@@ -0,0 +1,216 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <span>
+#include <string_view>
+
+#include <libhal/error.hpp>
+
+#include <diode_scanner.hpp>
+
+#include "check.hpp"
+#include "fakes.hpp"
+
+namespace {
+using namespace std::chrono_literals;
+using e10::test::expect;
+
+/// Reference voltage divider reading of every test
+constexpr float reference_reading = 0.75f;
+
+/// Scanner wired to fakes that log the pins and intensity conversions
+struct scanner_rig
+{
+  e10::test::fake_clock clock{};
+  e10::test::io_log log{};
+  e10::test::fake_output_pin counter_reset{ clock, log, 'r' };
+  e10::test::fake_output_pin counter_clock{ clock, log, 'c' };
+  e10::test::fake_output_pin frequency_select{ clock, log, 'f' };
+  e10::test::fake_adc intensity{ clock, log, 'i' };
+  e10::test::fake_adc reference{ reference_reading };
+  e10::test::fake_timer timer{ clock };
+  e10::diode_scanner scanner{ { .counter_reset = counter_reset,
+                                .counter_clock = counter_clock,
+                                .frequency_select = frequency_select,
+                                .intensity = intensity,
+                                .reference = reference,
+                                .clock = clock,
+                                .timer = timer } };
+
+  /// Events of the named devices, in order
+  e10::test::io_log events_of(std::string_view p_devices) const
+  {
+    e10::test::io_log events;
+    std::ranges::copy_if(
+      log, std::back_inserter(events), [p_devices](auto const& p_event) {
+        return p_devices.find(p_event.device) != std::string_view::npos;
+      });
+    return events;
+  }
+};
+
+hal::u64 ticks(hal::time_duration p_duration)
+{
+  return static_cast<hal::u64>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(p_duration).count());
+}
+
+/**
+ * @brief Pin writes and conversions of the blocking sampler the scanner
+ * replaced, which waited with hal::delay() between them
+ *
+ * @param p_time - start of the sweep, moved to its end
+ * @param p_log - log to append the sweep to
+ */
+void blocking_sweep(hal::u64& p_time, e10::test::io_log& p_log)
+{
+  auto const write = [&](char p_pin, bool p_level) {
+    p_log.push_back({ .time = p_time, .device = p_pin, .level = p_level });
+  };
+
+  write('r', true);
+  p_time += ticks(10us);
+  write('r', false);
+  for (std::size_t diode = 0; diode < e10::diode_count; diode++) {
+    write('c', true);
+    p_time += ticks(3ms);
+    write('c', false);
+    p_time += ticks(5ms);
+    p_log.push_back({ .time = p_time, .device = 'i' });
+  }
+  write('r', true);
+  write('c', true);
+}
+}  // namespace
+
+int main()
+{
+  e10::test::run("starting schedules the sweep instead of running it", [] {
+    scanner_rig rig;
+    rig.scanner.start();
+    expect(rig.clock.now() == 0);
+    expect(rig.timer.delay() == e10::diode_timing{}.reset_hold);
+    expect(rig.intensity.conversions == 0);
+  });
+
+  e10::test::run("sweeps keep the blocking sampler's edges and delays", [] {
+    scanner_rig rig;
+    rig.log.clear();
+    rig.scanner.start();
+    auto const sweep = e10::sweep_duration(rig.scanner.timing());
+    rig.timer.run_for(2 * sweep);
+
+    e10::test::io_log expected;
+    hal::u64 time = 0;
+    blocking_sweep(time, expected);
+    blocking_sweep(time, expected);
+    expect(time == ticks(2 * sweep));
+
+    auto const actual = rig.events_of("rci");
+    if (expect(actual.size() >= expected.size())) {
+      expect(std::equal(expected.begin(), expected.end(), actual.begin()));
+    }
+
+    // Low frequency first, then high
+    auto const selects = rig.events_of("f");
+    if (expect(selects.size() >= 2)) {
+      expect(selects[0].time == 0 && not selects[0].level);
+      expect(selects[1].time == ticks(sweep) && selects[1].level);
+    }
+    expect(rig.scanner.sweeps_completed(e10::irb_freq::low) == 1);
+    expect(rig.scanner.sweeps_completed(e10::irb_freq::high) == 1);
+  });
+
+  e10::test::run("readings are mapped relative to the reference", [] {
+    scanner_rig rig;
+    rig.intensity.queued = { 0.0f, 0.1875f, 0.375f, 0.75f, 0.9f };
+    rig.intensity.value = 0.375f;
+    rig.scanner.start();
+    rig.timer.run_for(e10::sweep_duration(rig.scanner.timing()));
+
+    auto const sweep = rig.scanner.latest(e10::irb_freq::low);
+    expect(sweep.reference == reference_reading);
+    expect(sweep.completed_at == rig.clock.now());
+    expect(sweep.intensity[0] == 0 && sweep.samples[0] == 0);
+    expect(sweep.intensity[1] == 16383 && sweep.samples[1] == 63);
+    expect(sweep.intensity[2] == 32767 && sweep.samples[2] == 127);
+    // Readings at or above the reference saturate
+    expect(sweep.intensity[3] == 65535 && sweep.samples[3] == 255);
+    expect(sweep.intensity[4] == 65535 && sweep.samples[4] == 255);
+    expect(sweep.intensity[7] == 32767);
+  });
+
+  e10::test::run("timing changes wait for the next sweep", [] {
+    scanner_rig rig;
+    rig.scanner.start();
+    rig.timer.run_for(1ms);
+
+    auto timing = rig.scanner.timing();
+    timing.integration = 1ms;
+    timing.settle = 2ms;
+    rig.scanner.set_timing(timing);
+    expect(rig.scanner.timing().integration == e10::diode_timing{}.integration);
+
+    rig.timer.run_for(e10::sweep_duration(e10::diode_timing{}) - 1ms);
+    expect(rig.scanner.sweeps_completed(e10::irb_freq::low) == 1);
+    expect(rig.scanner.timing().integration == 1ms);
+    expect(rig.scanner.timing().settle == 2ms);
+  });
+
+  e10::test::run("each diode is a filtered burst of conversions", [] {
+    scanner_rig rig;
+    rig.scanner.set_oversampling(
+      { .count = 5, .filter = e10::sample_filter::median });
+    // A spike in the first diode's burst
+    rig.intensity.queued = { 0.375f, 0.375f, 0.75f, 0.375f, 0.375f };
+    rig.intensity.value = 0.1875f;
+    rig.scanner.start();
+    rig.timer.run_for(e10::sweep_duration(rig.scanner.timing()));
+
+    expect(rig.intensity.conversions == 5 * e10::diode_count);
+    auto const sweep = rig.scanner.latest(e10::irb_freq::low);
+    expect(sweep.intensity[0] == 32767);
+    expect(sweep.intensity[1] == 16383);
+
+    // The burst is taken back to back, after the settle time
+    auto const conversions = rig.events_of("i");
+    auto const settled = ticks(e10::diode_timing{}.reset_hold +
+                               e10::diode_timing{}.integration +
+                               e10::diode_timing{}.settle);
+    expect(std::ranges::all_of(
+      std::span(conversions).first(5),
+      [settled](auto const& p_event) { return p_event.time == settled; }));
+  });
+
+  e10::test::run("oversampling outside of 1 to 16 is rejected", [] {
+    scanner_rig rig;
+    auto const rejected = [&rig](hal::u8 p_count) {
+      try {
+        rig.scanner.set_oversampling({ .count = p_count });
+      } catch (hal::argument_out_of_domain const&) {
+        return true;
+      }
+      return false;
+    };
+    expect(rejected(0));
+    expect(not rejected(1));
+    expect(not rejected(e10::oversampling::max_count));
+    expect(rejected(e10::oversampling::max_count + 1));
+  });
+
+  return e10::test::summary();
+}
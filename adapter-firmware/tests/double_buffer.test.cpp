@@ -0,0 +1,90 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <thread>
+
+#include <double_buffer.hpp>
+
+#include "check.hpp"
+
+namespace {
+/// Large enough that a copy is not a single load
+struct sample
+{
+  std::array<hal::u32, 32> values{};
+};
+
+constexpr hal::u32 publishes = 200'000;
+}  // namespace
+
+int main()
+{
+  using e10::test::expect;
+
+  e10::test::run("read returns the last published value", [] {
+    e10::double_buffer<sample> buffer;
+    expect(buffer.generation() == 0);
+    expect(buffer.read().values[0] == 0);
+
+    buffer.back().values.fill(7);
+    expect(buffer.read().values[0] == 0);
+    buffer.publish();
+    expect(buffer.generation() == 1);
+    expect(buffer.read().values[0] == 7);
+
+    buffer.back().values.fill(9);
+    buffer.publish();
+    expect(buffer.generation() == 2);
+    expect(buffer.read().values[31] == 9);
+  });
+
+  e10::test::run("reads on another thread are never torn", [] {
+    e10::double_buffer<sample> buffer;
+    std::atomic<bool> done = false;
+    hal::u32 torn = 0;
+    hal::u32 went_back = 0;
+
+    std::thread reader([&] {
+      hal::u32 last = 0;
+      while (not done.load(std::memory_order_acquire)) {
+        auto const copy = buffer.read();
+        auto const first = copy.values.front();
+        if (not std::ranges::all_of(copy.values,
+                                    [first](auto p_v) { return p_v == first; })) {
+          torn++;
+        }
+        if (first < last) {
+          went_back++;
+        }
+        last = first;
+      }
+    });
+
+    for (hal::u32 i = 1; i <= publishes; i++) {
+      buffer.back().values.fill(i);
+      buffer.publish();
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    expect(torn == 0);
+    expect(went_back == 0);
+    expect(buffer.read().values[0] == publishes);
+  });
+
+  return e10::test::summary();
+}
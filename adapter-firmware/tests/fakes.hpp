@@ -0,0 +1,346 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <libhal/adc.hpp>
+#include <libhal/functional.hpp>
+#include <libhal/output_pin.hpp>
+#include <libhal/serial.hpp>
+#include <libhal/steady_clock.hpp>
+#include <libhal/timer.hpp>
+#include <libhal/units.hpp>
+
+namespace e10::test {
+/**
+ * @brief Clock that only moves when a test advances it
+ *
+ * Ticks are nanoseconds.
+ */
+class fake_clock : public hal::steady_clock
+{
+public:
+  /**
+   * @brief Move the clock forward
+   *
+   * @param p_duration - time to add
+   */
+  void advance(hal::time_duration p_duration)
+  {
+    m_uptime += static_cast<hal::u64>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(p_duration)
+        .count());
+  }
+
+  /// Current uptime in ticks
+  hal::u64 now() const
+  {
+    return m_uptime;
+  }
+
+private:
+  hal::hertz driver_frequency() override
+  {
+    return 1e9f;
+  }
+
+  hal::u64 driver_uptime() override
+  {
+    return m_uptime;
+  }
+
+  hal::u64 m_uptime = 0;
+};
+
+/**
+ * @brief Serial port whose received bytes are queued by the test and whose
+ * written bytes are kept for the test to check
+ *
+ */
+class fake_serial : public hal::serial
+{
+public:
+  /// Size of the simulated receive buffer
+  static constexpr std::size_t capacity = 64;
+
+  /**
+   * @brief Queue bytes as if they were received
+   *
+   * @param p_bytes - bytes to receive
+   */
+  void receive(std::span<hal::byte const> p_bytes)
+  {
+    m_received.insert(m_received.end(), p_bytes.begin(), p_bytes.end());
+  }
+
+  /// Every byte written since the last take_written()
+  std::vector<hal::byte> take_written()
+  {
+    return std::exchange(m_written, {});
+  }
+
+  /// Baud rate of the last configure()
+  hal::u32 baud_rate = 0;
+  /// Number of configure() calls
+  int configures = 0;
+
+private:
+  void driver_configure(settings const& p_settings) override
+  {
+    baud_rate = p_settings.baud_rate;
+    configures++;
+  }
+
+  write_t driver_write(std::span<hal::byte const> p_data) override
+  {
+    m_written.insert(m_written.end(), p_data.begin(), p_data.end());
+    return { .data = p_data };
+  }
+
+  read_t driver_read(std::span<hal::byte> p_data) override
+  {
+    auto const count = std::min(p_data.size(), m_received.size());
+    std::copy_n(m_received.begin(), count, p_data.begin());
+    m_received.erase(m_received.begin(), m_received.begin() + count);
+    return { .data = p_data.first(count),
+             .available = m_received.size(),
+             .capacity = capacity };
+  }
+
+  void driver_flush() override
+  {
+    m_received.clear();
+  }
+
+  std::deque<hal::byte> m_received;
+  std::vector<hal::byte> m_written;
+};
+
+/**
+ * @brief Pin level written or ADC conversion made by a fake
+ *
+ */
+struct io_event
+{
+  /// Clock uptime of the event
+  hal::u64 time = 0;
+  /// Name the fake was given
+  char device = 0;
+  /// Level written to a pin, false for an ADC conversion
+  bool level = false;
+
+  bool operator==(io_event const&) const = default;
+};
+
+/// Events of several fakes in the order they happened
+using io_log = std::vector<io_event>;
+
+/**
+ * @brief Output pin that logs every level written to it
+ *
+ */
+class fake_output_pin : public hal::output_pin
+{
+public:
+  /**
+   * @brief Construct a new fake output pin
+   *
+   * @param p_clock - clock the events are time stamped with
+   * @param p_log - log to append the events to
+   * @param p_name - device name of the events
+   */
+  fake_output_pin(fake_clock& p_clock, io_log& p_log, char p_name)
+    : m_clock(&p_clock)
+    , m_log(&p_log)
+    , m_name(p_name)
+  {
+  }
+
+private:
+  void driver_configure(settings const&) override
+  {
+  }
+
+  void driver_level(bool p_high) override
+  {
+    m_level = p_high;
+    m_log->push_back(
+      { .time = m_clock->now(), .device = m_name, .level = p_high });
+  }
+
+  bool driver_level() override
+  {
+    return m_level;
+  }
+
+  fake_clock* m_clock;
+  io_log* m_log;
+  char m_name;
+  bool m_level = false;
+};
+
+/**
+ * @brief ADC returning readings queued by the test, then a fixed reading
+ *
+ */
+class fake_adc : public hal::adc
+{
+public:
+  /**
+   * @brief Construct a new fake ADC that does not log its conversions
+   *
+   * @param p_value - reading once the queued readings are used up
+   */
+  explicit fake_adc(float p_value = 0.0f)
+    : value(p_value)
+  {
+  }
+
+  /**
+   * @brief Construct a new fake ADC that logs its conversions
+   *
+   * @param p_clock - clock the events are time stamped with
+   * @param p_log - log to append the events to
+   * @param p_name - device name of the events
+   */
+  fake_adc(fake_clock& p_clock, io_log& p_log, char p_name)
+    : m_clock(&p_clock)
+    , m_log(&p_log)
+    , m_name(p_name)
+  {
+  }
+
+  /// Readings returned before `value`, front first
+  std::deque<float> queued{};
+  /// Reading once `queued` is empty
+  float value = 0.0f;
+  /// Number of conversions
+  hal::u32 conversions = 0;
+
+private:
+  float driver_read() override
+  {
+    conversions++;
+    if (m_log != nullptr) {
+      m_log->push_back({ .time = m_clock->now(), .device = m_name });
+    }
+    if (queued.empty()) {
+      return value;
+    }
+    auto const reading = queued.front();
+    queued.pop_front();
+    return reading;
+  }
+
+  fake_clock* m_clock = nullptr;
+  io_log* m_log = nullptr;
+  char m_name = 0;
+};
+
+/**
+ * @brief Timer whose callback runs when the test moves the clock to it
+ *
+ */
+class fake_timer : public hal::timer
+{
+public:
+  /**
+   * @brief Construct a new fake timer
+   *
+   * @param p_clock - clock moved forward to each callback
+   */
+  explicit fake_timer(fake_clock& p_clock)
+    : m_clock(&p_clock)
+  {
+  }
+
+  /**
+   * @brief Run the scheduled callback, moving the clock forward to its time
+   *
+   * @return true - a callback was scheduled and has run
+   */
+  bool fire()
+  {
+    if (not m_callback) {
+      return false;
+    }
+    if (m_due > m_clock->now()) {
+      m_clock->advance(std::chrono::nanoseconds(m_due - m_clock->now()));
+    }
+    // The callback may schedule the next one
+    auto callback = std::exchange(m_callback, {});
+    callback();
+    return true;
+  }
+
+  /**
+   * @brief Run every callback that falls due within a duration
+   *
+   * @param p_duration - time to move the clock forward by
+   */
+  void run_for(hal::time_duration p_duration)
+  {
+    auto const end = m_clock->now() + ticks(p_duration);
+    while (m_callback && m_due <= end) {
+      fire();
+    }
+    m_clock->advance(std::chrono::nanoseconds(end - m_clock->now()));
+  }
+
+  /// Delay the scheduled callback was given
+  hal::time_duration delay() const
+  {
+    return m_delay;
+  }
+
+private:
+  static hal::u64 ticks(hal::time_duration p_duration)
+  {
+    return static_cast<hal::u64>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(p_duration)
+        .count());
+  }
+
+  bool driver_is_running() override
+  {
+    return static_cast<bool>(m_callback);
+  }
+
+  void driver_cancel() override
+  {
+    m_callback = {};
+  }
+
+  void driver_schedule(hal::callback<void(void)> p_callback,
+                       hal::time_duration p_delay) override
+  {
+    m_callback = std::move(p_callback);
+    m_delay = p_delay;
+    m_due = m_clock->now() + ticks(p_delay);
+  }
+
+  fake_clock* m_clock;
+  hal::callback<void(void)> m_callback{};
+  hal::time_duration m_delay{};
+  hal::u64 m_due = 0;
+};
+}  // namespace e10::test
@@ -0,0 +1,159 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <e10_protocol.hpp>
+
+#include "check.hpp"
+
+namespace {
+using e10::test::expect;
+namespace protocol = e10::protocol;
+
+/// Encode a frame into a byte vector
+std::vector<std::uint8_t> encode(std::uint8_t p_sequence,
+                                 std::uint8_t p_command,
+                                 std::vector<std::uint8_t> const& p_payload)
+{
+  std::vector<std::uint8_t> bytes(p_payload.size() + protocol::frame_overhead);
+  protocol::encode_frame(
+    p_sequence, p_command, p_payload.data(), p_payload.size(), bytes.data());
+  return bytes;
+}
+
+/// Push every byte, collecting each frame as soon as it is complete
+std::vector<protocol::frame> feed(protocol::frame_parser& p_parser,
+                                  std::vector<std::uint8_t> const& p_bytes)
+{
+  std::vector<protocol::frame> frames;
+  protocol::frame frame;
+  for (auto const byte : p_bytes) {
+    p_parser.push(byte);
+    while (p_parser.next(frame)) {
+      frames.push_back(frame);
+    }
+  }
+  return frames;
+}
+
+std::vector<std::uint8_t> join(std::vector<std::uint8_t> p_first,
+                               std::vector<std::uint8_t> const& p_second)
+{
+  p_first.insert(p_first.end(), p_second.begin(), p_second.end());
+  return p_first;
+}
+}  // namespace
+
+int main()
+{
+  e10::test::run("CRC-16/CCITT-FALSE check value", [] {
+    std::array<std::uint8_t, 9> const check{ '1', '2', '3', '4', '5',
+                                             '6', '7', '8', '9' };
+    expect(protocol::crc16(check.data(), check.size()) == 0x29B1);
+    // Continuing a CRC gives the same result as one pass
+    auto const first = protocol::crc16(check.data(), 4);
+    expect(protocol::crc16(check.data() + 4, 5, first) == 0x29B1);
+  });
+
+  e10::test::run("encoded frames decode byte by byte", [] {
+    auto const bytes = encode(42, 'p', { 1, 2, 3 });
+    expect(bytes.size() == 3 + protocol::frame_overhead);
+    expect(bytes[0] == protocol::frame_sync && bytes[1] == 3);
+
+    protocol::frame_parser parser;
+    auto const frames = feed(parser, bytes);
+    if (expect(frames.size() == 1)) {
+      expect(frames[0].sequence == 42 && frames[0].command == 'p');
+      expect(frames[0].length == 3);
+      expect(frames[0].payload[0] == 1 && frames[0].payload[2] == 3);
+    }
+    expect(not parser.in_frame());
+    expect(parser.crc_errors() == 0 && parser.discarded() == 0);
+  });
+
+  e10::test::run("the largest payload round trips", [] {
+    std::vector<std::uint8_t> payload(protocol::max_payload_size);
+    for (std::size_t i = 0; i < payload.size(); i++) {
+      payload[i] = static_cast<std::uint8_t>(i * 7);
+    }
+    protocol::frame_parser parser;
+    auto const frames = feed(parser, encode(1, 'x', payload));
+    if (expect(frames.size() == 1)) {
+      expect(frames[0].length == protocol::max_payload_size);
+      expect(frames[0].payload[127] == static_cast<std::uint8_t>(127 * 7));
+    }
+  });
+
+  e10::test::run("bytes before a sync byte are discarded", [] {
+    protocol::frame_parser parser;
+    auto const frames =
+      feed(parser, join({ 0x00, 'v', 0xFF }, encode(3, 'v', {})));
+    expect(frames.size() == 1 && frames[0].sequence == 3);
+    expect(parser.discarded() == 3);
+  });
+
+  e10::test::run("a bad CRC costs only the damaged frame", [] {
+    auto damaged = encode(1, 'p', { 9 });
+    damaged.back() ^= 0x01;
+    protocol::frame_parser parser;
+    auto const frames = feed(parser, join(damaged, encode(2, 'v', {})));
+    if (expect(frames.size() == 1)) {
+      expect(frames[0].sequence == 2 && frames[0].command == 'v');
+    }
+    expect(parser.crc_errors() == 1);
+    // Every byte of the damaged frame but its sync byte was searched past
+    expect(parser.discarded() == damaged.size() - 1);
+  });
+
+  e10::test::run("a sync byte inside a damaged frame is resynced past", [] {
+    // The payload looks like the start of a frame with a two byte payload,
+    // which swallows the first bytes of the frame after it.
+    auto damaged = encode(1, 'p', { protocol::frame_sync, 2, 0, 0 });
+    damaged[4 + 3] ^= 0xFF;
+    protocol::frame_parser parser;
+    auto const frames = feed(parser, join(damaged, encode(5, 'a', {})));
+    if (expect(frames.size() == 1)) {
+      expect(frames[0].sequence == 5 && frames[0].command == 'a');
+    }
+    expect(parser.crc_errors() == 2);
+  });
+
+  e10::test::run("an impossible length is resynced past", [] {
+    std::vector<std::uint8_t> const bogus{ protocol::frame_sync, 200 };
+    protocol::frame_parser parser;
+    auto const frames = feed(parser, join(bogus, encode(6, 'v', {})));
+    expect(frames.size() == 1 && frames[0].sequence == 6);
+    expect(parser.crc_errors() == 0);
+  });
+
+  e10::test::run("a frame split across pushes waits for the rest", [] {
+    auto const bytes = encode(7, 'p', { 1 });
+    protocol::frame_parser parser;
+    std::vector<std::uint8_t> const head(bytes.begin(), bytes.begin() + 4);
+    std::vector<std::uint8_t> const tail(bytes.begin() + 4, bytes.end());
+    expect(feed(parser, head).empty());
+    expect(parser.in_frame());
+    expect(feed(parser, tail).size() == 1);
+
+    expect(feed(parser, head).empty());
+    parser.reset();
+    expect(not parser.in_frame());
+    expect(parser.discarded() == head.size());
+  });
+
+  return e10::test::summary();
+}
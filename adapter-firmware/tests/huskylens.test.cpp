@@ -0,0 +1,208 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <span>
+
+#include <libhal-util/i2c.hpp>
+
+#include <camera_link.hpp>
+#include <counting_i2c.hpp>
+#include <huskylens.hpp>
+#include <platforms/host_camera.hpp>
+
+#include "check.hpp"
+#include "fakes.hpp"
+
+namespace {
+using e10::test::expect;
+namespace huskylens = e10::huskylens;
+
+/// Header, command, algorithm and length bytes of every response
+constexpr hal::u32 response_header = 5;
+
+/// Simulated camera behind a transaction counter
+struct camera_rig
+{
+  e10::test::fake_clock clock{};
+  e10::test::fake_serial console{};
+  e10::host::simulated_camera camera{};
+  e10::counting_i2c bus{ camera };
+  e10::camera_link link{ bus, clock, huskylens::camera_address };
+  std::array<hal::byte, 64> buffer{};
+};
+
+/**
+ * @brief Reader the firmware used before responses were read in two
+ * transactions, kept to measure what the change saves
+ *
+ * Every header, command, algorithm, length, payload and checksum byte is its
+ * own one byte I2C read.
+ *
+ * @param p_i2c - camera bus
+ * @param p_buffer - filled with the command, payload and checksum
+ * @return std::span<hal::byte> - command, payload and received checksum
+ */
+std::span<hal::byte> byte_at_a_time_response(hal::i2c& p_i2c,
+                                             std::span<hal::byte> p_buffer)
+{
+  auto const read_byte = [&p_i2c]() {
+    return hal::read<1>(p_i2c, huskylens::camera_address).front();
+  };
+
+  hal::byte header = 0x00;
+  for (int attempts = 0; header != huskylens::header1 && attempts < 32;
+       attempts++) {
+    header = read_byte();
+  }
+  for (int attempts = 0; header != huskylens::header2 && attempts < 32;
+       attempts++) {
+    header = read_byte();
+  }
+  auto const command = read_byte();
+  read_byte();  // Algorithm
+  auto const length = read_byte();
+
+  p_buffer[0] = command;
+  for (std::size_t i = 0; i < length; i++) {
+    p_buffer[i + 1] = read_byte();
+  }
+  p_buffer[length + 1] = read_byte();
+  return p_buffer.first(length + 2);
+}
+}  // namespace
+
+int main()
+{
+  e10::test::run("a response is read in two transactions", [] {
+    camera_rig rig;
+    huskylens::send_knock(rig.link, rig.console);
+    auto const before = rig.bus.transactions();
+    auto const bytes_before = rig.bus.bytes();
+
+    auto const response = huskylens::read_response_data(rig.buffer, rig.link);
+    // Command, a one byte payload, received and calculated checksum
+    if (expect(response.size() == 4)) {
+      expect(response[0] == 0x00 && response[1] == huskylens::result_ok);
+      expect(response[2] == response[3]);
+    }
+    expect(rig.bus.transactions() - before == 2);
+    auto const bytes = rig.bus.bytes() - bytes_before;
+
+    // The byte at a time reader needs a transaction for each of the same bytes
+    huskylens::send_knock(rig.link, rig.console);
+    auto const old_before = rig.bus.transactions();
+    auto const old_bytes_before = rig.bus.bytes();
+    auto const old = byte_at_a_time_response(rig.bus, rig.buffer);
+    expect(old.size() == 3 && old[1] == huskylens::result_ok);
+    expect(rig.bus.transactions() - old_before == 7);
+    expect(rig.bus.bytes() - old_bytes_before == bytes);
+  });
+
+  e10::test::run("a block result takes a fraction of the transactions", [] {
+    auto const add_objects = [](e10::host::simulated_camera& p_camera) {
+      p_camera.add_object({ .command = huskylens::block_response,
+                            .id = 1,
+                            .geometry = { 160, 120, 20, 30 } });
+      p_camera.add_object({ .command = huskylens::arrow_response,
+                            .id = 2,
+                            .geometry = { 10, 20, 30, 40 } });
+    };
+    std::array<hal::byte, 6> const request{
+      huskylens::header1,
+      huskylens::header2,
+      huskylens::request_blocks_cmd,
+      huskylens::any_algo,
+      0x00,
+      hal::byte(huskylens::header1 + huskylens::header2 +
+                huskylens::request_blocks_cmd),
+    };
+
+    camera_rig before;
+    add_objects(before.camera);
+    hal::write(before.bus, huskylens::camera_address, request);
+    // The info response, then both objects
+    for (int response = 0; response < 3; response++) {
+      byte_at_a_time_response(before.bus, before.buffer);
+    }
+
+    camera_rig after;
+    add_objects(after.camera);
+    auto const frame = huskylens::get_camera_data(
+      after.buffer, after.link, after.console, huskylens::any_algo);
+    expect(frame.object_count == 2);
+
+    expect(before.bus.bytes() == after.bus.bytes());
+    expect(before.bus.transactions() == 1 + response_header * 3 + 2 + 2 * 11);
+    expect(after.bus.transactions() == 1 + 3 * 2);
+    std::printf("  2 object result: %u transactions byte at a time, %u now\n",
+                unsigned(before.bus.transactions()),
+                unsigned(after.bus.transactions()));
+  });
+
+  e10::test::run("a block result costs two reads per response", [] {
+    camera_rig rig;
+    rig.camera.add_object({ .command = huskylens::block_response,
+                            .id = 1,
+                            .geometry = { 160, 120, 20, 30 } });
+    rig.camera.add_object({ .command = huskylens::arrow_response,
+                            .id = 2,
+                            .geometry = { 10, 20, 30, 40 } });
+
+    auto const frame = huskylens::get_camera_data(
+      rig.buffer, rig.link, rig.console, huskylens::any_algo);
+    expect(frame.object_count == 2);
+    expect(frame.objects[0].kind == e10::protocol::camera_object::block);
+    expect(frame.objects[1].kind == e10::protocol::camera_object::arrow);
+    // 16-bit values, low byte first
+    expect(frame.objects[1].geometry[4] == 30);
+    expect(frame.block[0] == 160 && frame.block[2] == 120);
+
+    // The request, then the info and both objects. The info block carries
+    // just the object count.
+    constexpr hal::u32 info_payload = 1;
+    constexpr hal::u32 object_payload = 10;
+    expect(rig.bus.transactions() == 1 + 3 * 2);
+    expect(rig.bus.bytes() == 6 + (response_header + info_payload + 1) +
+                                2 * (response_header + object_payload + 1));
+    expect(rig.link.stats().resyncs == 0);
+  });
+
+  e10::test::run("an empty result is just the info block", [] {
+    camera_rig rig;
+    auto const frame = huskylens::get_camera_data(
+      rig.buffer, rig.link, rig.console, huskylens::any_algo);
+    expect(frame.object_count == 0);
+    expect(frame.block == decltype(frame.block){});
+    expect(rig.bus.transactions() == 1 + 2);
+  });
+
+  e10::test::run("junk before the header is skipped within the read", [] {
+    camera_rig rig;
+    rig.camera.add_garbage(3);
+    rig.camera.add_object({ .command = huskylens::block_response, .id = 4 });
+
+    auto const frame = huskylens::get_camera_data(
+      rig.buffer, rig.link, rig.console, huskylens::any_algo);
+    expect(frame.object_count == 1 && frame.objects[0].id == 4);
+    // The header read found the header behind the junk, only the bytes it
+    // pushed out of the header are read again
+    expect(rig.bus.transactions() == 1 + 3 + 2);
+    expect(rig.link.stats().resyncs == 0);
+  });
+
+  return e10::test::summary();
+}
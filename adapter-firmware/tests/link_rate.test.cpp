@@ -0,0 +1,155 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include <e10_protocol.hpp>
+#include <link_rate.hpp>
+
+#include "check.hpp"
+#include "fakes.hpp"
+
+namespace {
+/// Time the brain has to confirm a rate
+constexpr auto trial =
+  std::chrono::milliseconds(e10::protocol::baud_rate_trial_ms);
+}  // namespace
+
+int main()
+{
+  using namespace std::chrono_literals;
+  using e10::test::expect;
+  using outcome = e10::link_rate::outcome;
+
+  e10::test::run("unknown rates are rejected", [] {
+    e10::test::fake_clock clock;
+    e10::link_rate link(clock);
+    expect(link.rate() == 115200);
+    expect(link.request(e10::protocol::baud_rate_count) == outcome::rejected);
+    expect(link.rate() == 115200);
+    expect(not link.revert_if_expired());
+  });
+
+  e10::test::run("a confirmed rate is kept", [] {
+    e10::test::fake_clock clock;
+    e10::link_rate link(clock);
+    expect(link.request(3) == outcome::trial_started);
+    expect(link.rate() == 921600);
+    clock.advance(trial - 1ms);
+    expect(link.request(3) == outcome::confirmed);
+
+    clock.advance(10s);
+    expect(not link.revert_if_expired());
+    expect(link.rate() == 921600);
+  });
+
+  e10::test::run("a missed confirmation reverts to the first rate", [] {
+    e10::test::fake_clock clock;
+    e10::link_rate link(clock);
+    link.request(1);
+    link.request(1);
+    expect(link.rate() == 230400);
+
+    expect(link.request(2) == outcome::trial_started);
+    clock.advance(trial - 1ms);
+    expect(not link.revert_if_expired());
+    expect(link.rate() == 460800);
+    clock.advance(1ms);
+    expect(link.revert_if_expired());
+    expect(link.rate() == 115200);
+    // Only reported once
+    expect(not link.revert_if_expired());
+
+    // A confirmation arriving after the revert starts a new trial
+    expect(link.request(2) == outcome::trial_started);
+  });
+
+  e10::test::run("another rate during a trial restarts it", [] {
+    e10::test::fake_clock clock;
+    e10::link_rate link(clock);
+    link.request(3);
+    clock.advance(trial - 100ms);
+    expect(link.request(1) == outcome::trial_started);
+    expect(link.rate() == 230400);
+
+    // The trial is timed from the second request
+    clock.advance(trial - 1ms);
+    expect(not link.revert_if_expired());
+    expect(link.request(1) == outcome::confirmed);
+  });
+
+  e10::test::run("the probe tries every rate once", [] {
+    for (std::uint8_t current = 0; current < e10::protocol::baud_rate_count;
+         current++) {
+      std::array<int, e10::protocol::baud_rate_count> tries{};
+      for (std::uint8_t attempt = 0; attempt < e10::protocol::baud_rate_count;
+           attempt++) {
+        auto const index = e10::protocol::baud_rate_probe(current, attempt);
+        if (expect(index < e10::protocol::baud_rate_count)) {
+          tries[index]++;
+        }
+      }
+      expect(std::ranges::all_of(tries, [](int p_count) {
+        return p_count == 1;
+      }));
+      expect(e10::protocol::baud_rate_probe(current, 0) == current);
+      if (current != 0) {
+        expect(e10::protocol::baud_rate_probe(current, 1) == 0);
+      }
+    }
+  });
+
+  e10::test::run("a restarted brain finds the adapter at its kept rate", [] {
+    for (std::uint8_t kept = 0; kept < e10::protocol::baud_rate_count;
+         kept++) {
+      e10::test::fake_clock clock;
+      e10::link_rate link(clock);
+      if (kept != 0) {
+        link.request(kept);
+        expect(link.request(kept) == outcome::confirmed);
+      }
+
+      // The brain program restarts on the first rate while the adapter stays
+      // powered, the adapter keeps the confirmed rate for as long as it runs
+      clock.advance(10s);
+      expect(not link.revert_if_expired());
+      expect(link.rate() == e10::protocol::baud_rates[kept]);
+
+      // 'n' is only answered once the brain probes the adapter's rate
+      std::uint8_t brain = 0;
+      std::uint8_t attempts = 0;
+      for (std::uint8_t attempt = 0;
+           attempt < e10::protocol::baud_rate_count;
+           attempt++) {
+        brain = e10::protocol::baud_rate_probe(0, attempt);
+        attempts++;
+        if (e10::protocol::baud_rates[brain] == link.rate()) {
+          break;
+        }
+        clock.advance(trial);
+      }
+      expect(e10::protocol::baud_rates[brain] == link.rate());
+      // The rate a negotiating brain leaves the adapter on is found second
+      if (kept == e10::protocol::baud_rate_count - 1) {
+        expect(attempts == 2);
+      }
+      expect(not link.revert_if_expired());
+    }
+  });
+
+  return e10::test::summary();
+}
@@ -0,0 +1,122 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+#include <profile.hpp>
+
+#include "check.hpp"
+
+namespace {
+using e10::test::expect;
+
+constexpr auto interrupt_zone = e10::profile_zone::diode_step;
+constexpr auto main_zone = e10::profile_zone::camera_read;
+
+e10::profile_stats const& stats_of(e10::profile_stats_table const& p_table,
+                                   e10::profile_zone p_zone)
+{
+  return p_table[static_cast<std::size_t>(p_zone)];
+}
+}  // namespace
+
+int main()
+{
+  static_assert(e10::profiling_enabled);
+
+  e10::test::run("records count, min, max and total", [] {
+    e10::profile_reset();
+    e10::profile_record(main_zone, 30);
+    e10::profile_record(main_zone, 10);
+    e10::profile_record(main_zone, 20);
+
+    auto const stats = stats_of(e10::profile_snapshot(), main_zone);
+    expect(stats.count == 3);
+    expect(stats.min == 10 && stats.max == 30);
+    expect(stats.total == 60);
+
+    e10::profile_reset();
+    auto const cleared = stats_of(e10::profile_snapshot(), main_zone);
+    expect(cleared.count == 0 && cleared.total == 0);
+    expect(cleared.min == UINT32_MAX && cleared.max == 0);
+  });
+
+  e10::test::run("resets never tear a run recorded by an interrupt", [] {
+    // Every run takes the same time, so every consistent copy of the zone
+    // has total == count * run and min == max == run
+    constexpr std::uint32_t run = 5;
+    e10::profile_reset();
+    std::atomic<bool> done = false;
+    std::thread interrupt([&done] {
+      while (not done.load(std::memory_order_relaxed)) {
+        e10::profile_record(interrupt_zone, run);
+      }
+    });
+
+    int torn = 0;
+    for (int i = 0; i < 200'000; i++) {
+      auto const stats = stats_of(e10::profile_snapshot(), interrupt_zone);
+      auto const consistent =
+        stats.count == 0
+          ? stats.total == 0 && stats.min == UINT32_MAX && stats.max == 0
+          : stats.total == std::uint64_t{ stats.count } * run &&
+              stats.min == run && stats.max == run;
+      if (not consistent) {
+        torn++;
+      }
+      if (i % 2 == 0) {
+        e10::profile_reset();
+      }
+    }
+    done = true;
+    interrupt.join();
+    expect(torn == 0);
+  });
+
+  e10::test::run("overhead of a profiled zone", [] {
+    constexpr std::uint32_t runs = 200'000;
+    e10::profile_reset();
+
+    std::atomic<std::uint32_t> sink = 0;
+    auto const bare_start = e10::profile_counter();
+    for (std::uint32_t i = 0; i < runs; i++) {
+      sink.fetch_add(1, std::memory_order_relaxed);
+    }
+    auto const bare = e10::profile_counter() - bare_start;
+
+    auto const profiled_start = e10::profile_counter();
+    for (std::uint32_t i = 0; i < runs; i++) {
+      e10::profile_scope const scope(main_zone);
+      sink.fetch_add(1, std::memory_order_relaxed);
+    }
+    auto const profiled = e10::profile_counter() - profiled_start;
+
+    auto const stats = stats_of(e10::profile_snapshot(), main_zone);
+    expect(stats.count == runs);
+    expect(stats.min <= stats.max);
+
+    // Counter ticks are nanoseconds on the host
+    auto const per_zone =
+      (static_cast<double>(profiled) - static_cast<double>(bare)) / runs;
+    std::printf("profile_scope overhead: %.1f ns per zone on the host, "
+                "%.1f ns mean recorded run\n",
+                per_zone,
+                static_cast<double>(stats.total) / runs);
+  });
+
+  return e10::test::summary();
+}
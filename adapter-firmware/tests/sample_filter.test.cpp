@@ -0,0 +1,110 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <sample_filter.hpp>
+
+#include "check.hpp"
+
+namespace {
+using e10::test::expect;
+
+bool near(float p_actual, float p_expected, float p_tolerance = 1e-5f)
+{
+  return std::abs(p_actual - p_expected) <= p_tolerance;
+}
+
+/**
+ * @brief Readings of a steady signal with uniform noise and rare spikes
+ *
+ * Noise comes from a fixed linear congruential generator so the stream is the
+ * same on every run.
+ *
+ * @param p_count - number of readings
+ * @param p_signal - true reading
+ * @param p_noise - largest noise in either direction
+ * @param p_spike_every - every Nth reading is a full scale spike, 0 for none
+ */
+std::vector<float> noisy_stream(std::size_t p_count,
+                                float p_signal,
+                                float p_noise,
+                                std::size_t p_spike_every)
+{
+  std::uint32_t state = 12345;
+  std::vector<float> readings;
+  for (std::size_t i = 0; i < p_count; i++) {
+    state = state * 1'664'525u + 1'013'904'223u;
+    auto const uniform = static_cast<float>(state >> 8) / float(1 << 24);
+    auto reading = p_signal + (2.0f * uniform - 1.0f) * p_noise;
+    if (p_spike_every != 0 && i % p_spike_every == p_spike_every - 1) {
+      reading = 1.0f;
+    }
+    readings.push_back(reading);
+  }
+  return readings;
+}
+}  // namespace
+
+int main()
+{
+  using filter = e10::sample_filter;
+
+  e10::test::run("exact reductions of a short burst", [] {
+    std::array<float, 4> readings{ 0.4f, 0.1f, 0.9f, 0.2f };
+    expect(near(e10::reduce(readings, filter::mean), 0.4f));
+
+    readings = { 0.4f, 0.1f, 0.9f, 0.2f };
+    // Upper of the two middle readings for an even count
+    expect(near(e10::reduce(readings, filter::median), 0.4f));
+
+    readings = { 0.4f, 0.1f, 0.9f, 0.2f };
+    // Lowest and highest reading dropped
+    expect(near(e10::reduce(readings, filter::trimmed_mean), 0.3f));
+  });
+
+  e10::test::run("a single reading is returned by every filter", [] {
+    for (auto const method :
+         { filter::mean, filter::median, filter::trimmed_mean }) {
+      std::array<float, 1> readings{ 0.25f };
+      expect(e10::reduce(readings, method) == 0.25f);
+    }
+  });
+
+  e10::test::run("noise averages out of a steady signal", [] {
+    auto readings = noisy_stream(16, 0.5f, 0.05f, 0);
+    auto const single_error = std::abs(readings[0] - 0.5f);
+    auto const reduced = e10::reduce(readings, filter::mean);
+    expect(near(reduced, 0.5f, 0.02f));
+    expect(std::abs(reduced - 0.5f) <= single_error + 1e-6f);
+  });
+
+  e10::test::run("median and trimmed mean reject conversion spikes", [] {
+    // One spike in every eight readings
+    auto readings = noisy_stream(16, 0.3f, 0.01f, 8);
+    auto copy = readings;
+    expect(not near(e10::reduce(copy, filter::mean), 0.3f, 0.05f));
+
+    copy = readings;
+    expect(near(e10::reduce(copy, filter::median), 0.3f, 0.01f));
+
+    copy = readings;
+    expect(near(e10::reduce(copy, filter::trimmed_mean), 0.3f, 0.01f));
+  });
+
+  return e10::test::summary();
+}
@@ -0,0 +1,337 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include <libhal-util/enum.hpp>
+
+#include <command_queue.hpp>
+#include <e10_protocol.hpp>
+#include <stream_subscription.hpp>
+
+#include "check.hpp"
+#include "fakes.hpp"
+
+namespace {
+using namespace std::chrono_literals;
+
+/// Sequence number flag of every pushed snapshot
+constexpr hal::byte pushed = e10::protocol::pushed_sequence_flag;
+/// Time a byte takes on the RS485 link at 921600 baud, 10 bits per byte
+constexpr hal::u64 byte_ticks = 10'851;
+/// Time between two passes of the simulated main loop
+constexpr hal::u64 loop_ticks = 5'000;
+/// Time between two completed sweeps
+constexpr hal::u64 sweep_ticks = 16'000'000;
+/// Time between two requests from the brain
+constexpr hal::u64 request_ticks = 7'300'000;
+
+/// Outcome of a link simulation
+struct link_report
+{
+  /// Snapshots the brain received
+  int snapshots = 0;
+  /// Longest and mean time from a sweep completing to the brain holding it
+  hal::u64 max_age = 0;
+  hal::u64 mean_age = 0;
+  /// Requests sent and answered, a snapshot taken for an answer is a mismatch
+  int requests = 0;
+  int answered = 0;
+  int mismatched = 0;
+  /// Transmissions the adapter started while the brain was sending
+  int adapter_collisions = 0;
+  /// Requests the brain started while the adapter was sending
+  int brain_collisions = 0;
+};
+
+/**
+ * @brief Run an adapter streaming snapshots to a brain over a half-duplex link
+ *
+ * The adapter side follows the main loop: it reads requests with a
+ * command_reader, answers queued requests first, otherwise pushes a due
+ * snapshot, holding it back while a request is arriving if p_hold_off is set.
+ * Every transmission occupies the link for its bytes' wire time. Bytes of
+ * transmissions that overlap are lost to both sides.
+ *
+ * @param p_hold_off - hold pushes back while a request is arriving
+ * @param p_duration - simulated time in nanoseconds
+ * @return link_report - what the brain saw
+ */
+link_report simulate_link(bool p_hold_off, hal::u64 p_duration)
+{
+  struct transmission
+  {
+    hal::u64 start = 0;
+    hal::u64 end = 0;
+    std::vector<hal::byte> bytes{};
+    bool lost = false;
+  };
+
+  e10::test::fake_clock clock;
+  e10::test::fake_serial adapter_port;
+  e10::stream_subscription stream(clock);
+  e10::command_reader reader(clock, false);
+  e10::command_queue<4> commands;
+  e10::protocol::frame_parser brain_parser;
+  std::vector<hal::u64> sweep_times{ 0 };
+  hal::u32 sweeps = 1;
+  std::array<hal::byte, e10::protocol::max_frame_size> encoded{};
+
+  transmission brain{ .lost = true };
+  transmission adapter{ .lost = true };
+  std::size_t brain_delivered = 0;
+  hal::byte brain_sequence = 0;
+  hal::u64 next_request = request_ticks / 2;
+  hal::u64 total_age = 0;
+  link_report report{};
+
+  auto const encode = [&encoded](hal::byte p_sequence,
+                                 hal::byte p_command,
+                                 std::vector<hal::byte> const& p_payload) {
+    auto const length = e10::protocol::encode_frame(p_sequence,
+                                                    p_command,
+                                                    p_payload.data(),
+                                                    p_payload.size(),
+                                                    encoded.data());
+    return std::vector<hal::byte>(encoded.begin(), encoded.begin() + length);
+  };
+  auto const overlap = [](transmission const& p_a, transmission const& p_b) {
+    return p_a.start < p_b.end && p_b.start < p_a.end;
+  };
+  auto const adapter_send = [&](std::vector<hal::byte> p_bytes) {
+    auto const now = clock.now();
+    adapter = { .start = now,
+                .end = now + p_bytes.size() * byte_ticks,
+                .bytes = std::move(p_bytes) };
+    if (overlap(adapter, brain)) {
+      report.adapter_collisions++;
+      adapter.lost = brain.lost = true;
+    }
+  };
+
+  // The brain hears a transmission once its last byte has arrived
+  auto const brain_receive = [&]() {
+    for (auto const byte : adapter.bytes) {
+      brain_parser.push(byte);
+    }
+    e10::protocol::frame frame;
+    while (brain_parser.next(frame)) {
+      if (frame.sequence & pushed) {
+        hal::u32 sweep = 0;
+        std::copy_n(frame.payload.begin(), sizeof(sweep),
+                    reinterpret_cast<hal::byte*>(&sweep));
+        auto const age = clock.now() - sweep_times[sweep];
+        report.max_age = std::max(report.max_age, age);
+        total_age += age;
+        report.snapshots++;
+        continue;
+      }
+      if (frame.sequence == brain_sequence &&
+          frame.command == hal::value(e10::protocol::command::timing)) {
+        report.answered++;
+      } else {
+        report.mismatched++;
+      }
+    }
+  };
+
+  stream.subscribe(adapter_port, 10, true);
+  while (clock.now() < p_duration) {
+    clock.advance(std::chrono::nanoseconds(loop_ticks));
+    auto const now = clock.now();
+
+    if (now >= sweep_times.back() + sweep_ticks) {
+      sweep_times.push_back(now);
+      sweeps++;
+    }
+
+    // The brain sends requests on its own schedule, whatever the link does
+    if (now >= next_request) {
+      next_request += request_ticks;
+      brain_sequence =
+        static_cast<hal::byte>((brain_sequence + 1) % pushed);
+      auto const bytes = encode(
+        brain_sequence, hal::value(e10::protocol::command::timing), {});
+      brain = { .start = now,
+                .end = now + bytes.size() * byte_ticks,
+                .bytes = bytes };
+      brain_delivered = 0;
+      report.requests++;
+      if (overlap(brain, adapter)) {
+        report.brain_collisions++;
+        brain.lost = adapter.lost = true;
+      }
+    }
+    // Bytes of the brain's request reach the adapter one at a time
+    while (not brain.lost && brain_delivered < brain.bytes.size() &&
+           brain.start + (brain_delivered + 1) * byte_ticks <= now) {
+      adapter_port.receive(std::span(&brain.bytes[brain_delivered], 1));
+      brain_delivered++;
+    }
+    if (not adapter.bytes.empty() && now >= adapter.end) {
+      if (not adapter.lost) {
+        brain_receive();
+      }
+      adapter.bytes.clear();
+    }
+
+    reader.poll(adapter_port, commands);
+    if (now < adapter.end) {
+      continue;
+    }
+
+    e10::received_command received{};
+    if (commands.pop(received)) {
+      adapter_send(encode(received.request.sequence,
+                          received.request.command,
+                          std::vector<hal::byte>(6)));
+    } else if ((not p_hold_off || not reader.receiving()) &&
+               stream.due(sweeps)) {
+      // The payload starts with the sweep it was taken from
+      std::vector<hal::byte> payload(sizeof(e10::protocol::snapshot));
+      auto const sweep = sweeps - 1;
+      std::copy_n(reinterpret_cast<hal::byte const*>(&sweep),
+                  sizeof(sweep),
+                  payload.begin());
+      auto const sequence = stream.pushed(sweeps);
+      adapter_send(encode(
+        sequence, hal::value(e10::protocol::command::snapshot), payload));
+    }
+  }
+
+  report.mean_age = report.snapshots ? total_age / report.snapshots : 0;
+  return report;
+}
+}  // namespace
+
+int main()
+{
+  using e10::test::expect;
+
+  e10::test::run("nobody is subscribed at first", [] {
+    e10::test::fake_clock clock;
+    e10::stream_subscription stream(clock);
+    expect(stream.port() == nullptr);
+    expect(not stream.due(0));
+    clock.advance(1s);
+    expect(not stream.due(5));
+  });
+
+  e10::test::run("snapshots are spaced by the period", [] {
+    e10::test::fake_clock clock;
+    e10::test::fake_serial port;
+    e10::stream_subscription stream(clock);
+    stream.subscribe(port, 20, false);
+    expect(stream.port() == &port);
+
+    // The first snapshot is due right away
+    expect(stream.due(0));
+    expect(stream.pushed(0) == (pushed | 1));
+    expect(not stream.due(0));
+    clock.advance(19ms);
+    expect(not stream.due(3));
+    clock.advance(1ms);
+    expect(stream.due(0));
+    expect(stream.pushed(0) == (pushed | 2));
+
+    // A late push spaces the next one from when it was sent
+    clock.advance(35ms);
+    expect(stream.pushed(0) == (pushed | 3));
+    clock.advance(19ms);
+    expect(not stream.due(0));
+    clock.advance(1ms);
+    expect(stream.due(0));
+  });
+
+  e10::test::run("on change waits for a new sweep", [] {
+    e10::test::fake_clock clock;
+    e10::test::fake_serial port;
+    e10::stream_subscription stream(clock);
+    stream.subscribe(port, 10, true);
+
+    expect(not stream.due(0));
+    expect(stream.due(2));
+    stream.pushed(2);
+    clock.advance(50ms);
+    expect(not stream.due(2));
+    expect(stream.due(3));
+  });
+
+  e10::test::run("a zero period cancels the subscription", [] {
+    e10::test::fake_clock clock;
+    e10::test::fake_serial port;
+    e10::stream_subscription stream(clock);
+    stream.subscribe(port, 10, false);
+    stream.pushed(0);
+
+    stream.subscribe(port, 0, false);
+    expect(stream.port() == nullptr);
+    clock.advance(1s);
+    expect(not stream.due(1));
+
+    // Subscribing again restarts the schedule but not the sequence numbers
+    e10::test::fake_serial other;
+    stream.subscribe(other, 1000, false);
+    expect(stream.port() == &other);
+    expect(stream.due(0));
+    expect(stream.pushed(0) == (pushed | 2));
+  });
+
+  e10::test::run("pushed sequence numbers always carry the flag", [] {
+    e10::test::fake_clock clock;
+    e10::test::fake_serial port;
+    e10::stream_subscription stream(clock);
+    stream.subscribe(port, 1, false);
+    for (int push = 1; push < 300; push++) {
+      auto const sequence = stream.pushed(0);
+      expect((sequence & pushed) != 0);
+      expect((sequence & ~pushed) == push % pushed);
+    }
+  });
+
+  e10::test::run("snapshots stream over a half-duplex link", [] {
+    constexpr hal::u64 duration = 2'000'000'000;
+    auto const report = simulate_link(true, duration);
+
+    // One snapshot per sweep, taken right after the sweep completed. Only a
+    // request the brain sends over a push loses a snapshot.
+    expect(report.snapshots + report.brain_collisions >=
+           int(duration / sweep_ticks) - 1);
+    expect(report.max_age <= 1'000'000);
+    // Pushes never talk over a request, so only the requests the brain sent
+    // over a transmission go unanswered and no snapshot is taken for an answer
+    expect(report.adapter_collisions == 0);
+    expect(report.answered == report.requests - report.brain_collisions);
+    expect(report.mismatched == 0);
+
+    auto const without_hold_off = simulate_link(false, duration);
+    expect(without_hold_off.adapter_collisions > 0);
+
+    std::printf("  sample age: mean %.0fus, max %.0fus, %d snapshots, "
+                "%d/%d requests answered, %d pushes over a request without "
+                "the hold off\n",
+                static_cast<float>(report.mean_age) / 1e3f,
+                static_cast<float>(report.max_age) / 1e3f,
+                report.snapshots,
+                report.answered,
+                report.requests,
+                without_hold_off.adapter_collisions);
+  });
+
+  return e10::test::summary();
+}
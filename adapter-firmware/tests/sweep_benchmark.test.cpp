@@ -0,0 +1,119 @@
+// Copyright 2026 Khalil Estell and the libhal contributors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <cstdio>
+
+#include <diode_scanner.hpp>
+
+#include "check.hpp"
+#include "fakes.hpp"
+
+namespace {
+using namespace std::chrono_literals;
+using e10::test::expect;
+
+/**
+ * @brief Time the scanner takes to refresh both channels, in virtual time
+ *
+ * Runs the scanner on fakes until it is in its steady state, then measures
+ * the time between two consecutive results of the high channel, which is
+ * refreshed last in both modes.
+ *
+ * @param p_mode - channel ordering
+ * @param p_timing - multiplexer timing
+ * @return hal::time_duration - time between refreshes of both channels
+ */
+hal::time_duration measure_refresh(e10::sweep_mode p_mode,
+                                   e10::diode_timing const& p_timing)
+{
+  e10::test::fake_clock clock;
+  e10::test::io_log log;
+  e10::test::fake_output_pin counter_reset(clock, log, 'r');
+  e10::test::fake_output_pin counter_clock(clock, log, 'c');
+  e10::test::fake_output_pin frequency_select(clock, log, 'f');
+  e10::test::fake_adc intensity(0.5f);
+  e10::test::fake_adc reference(0.75f);
+  e10::test::fake_timer timer(clock);
+  e10::diode_scanner scanner({ .counter_reset = counter_reset,
+                               .counter_clock = counter_clock,
+                               .frequency_select = frequency_select,
+                               .intensity = intensity,
+                               .reference = reference,
+                               .clock = clock,
+                               .timer = timer });
+  scanner.set_mode(p_mode);
+  scanner.set_timing(p_timing);
+  scanner.start();
+
+  auto const high = e10::irb_freq::high;
+  auto const wait_for_sweep = [&](hal::u32 p_sweeps) {
+    while (scanner.sweeps_completed(high) < p_sweeps && timer.fire()) {
+    }
+    return scanner.latest(high).completed_at;
+  };
+  // The first refresh also picks up the timing, skip it
+  wait_for_sweep(2);
+  auto const start = wait_for_sweep(3);
+  auto const end = wait_for_sweep(4);
+  return std::chrono::nanoseconds(end - start);
+}
+
+/**
+ * @brief Measure and report both modes at one timing
+ *
+ * @param p_name - name of the timing in the report
+ * @param p_timing - multiplexer timing
+ */
+void benchmark(char const* p_name, e10::diode_timing const& p_timing)
+{
+  auto const sequential =
+    measure_refresh(e10::sweep_mode::sequential, p_timing);
+  auto const interleaved =
+    measure_refresh(e10::sweep_mode::interleaved, p_timing);
+
+  auto const ms = [](hal::time_duration p_time) {
+    return std::chrono::duration<double, std::milli>(p_time).count();
+  };
+  std::printf("%s timing: %.2f ms sequential, %.2f ms interleaved\n",
+              p_name,
+              ms(sequential),
+              ms(interleaved));
+
+  // The scanner must take exactly the modeled time 'b' reports
+  expect(sequential ==
+         e10::dual_sweep_duration(p_timing, e10::sweep_mode::sequential));
+  expect(interleaved ==
+         e10::dual_sweep_duration(p_timing, e10::sweep_mode::interleaved));
+  expect(interleaved < sequential);
+}
+}  // namespace
+
+int main()
+{
+  e10::test::run("default timing", [] {
+    benchmark("default", e10::diode_timing{});
+    expect(e10::dual_sweep_duration({}, e10::sweep_mode::sequential) ==
+           128'020us);
+    expect(e10::dual_sweep_duration({}, e10::sweep_mode::interleaved) ==
+           68'010us);
+  });
+
+  e10::test::run("calibrated timing", [] {
+    // Integration and settle times a calibration typically measures
+    benchmark("calibrated", { .integration = 1050us, .settle = 1650us });
+  });
+
+  return e10::test::summary();
+}
@@ -64,9 +64,556 @@ playVexcodeSound(const char* soundName)
 #include <cstdio>
 #include <cstdlib>
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
 #include <iterator>
 
+#pragma region E10 Protocol
+
+// Copy of adapter-firmware/include/e10_protocol.hpp, keep the two in sync.
+namespace e10 {
+namespace protocol {
+/**
+ * @brief Request bytes understood by the adapter on the RS485 link
+ *
+ * Unless stated otherwise, every response ends with a checksum byte that is
+ * the 8-bit sum of the bytes before it. Commands with a payload expect the
+ * payload to be followed by the same kind of checksum.
+ */
+enum class command : std::uint8_t
+{
+  /// Firmware version string, no checksum
+  version = 'v',
+  /// Raw low and high frequency samples, 8 bytes each
+  all_samples = 'a',
+  /// Strongest low frequency diode, see `beacon_report`
+  low = 'l',
+  /// Strongest high frequency diode, see `beacon_report`
+  high = 'h',
+  /// First object block of the latest camera result, 8 bytes
+  camera = 'c',
+  /// Negotiate the protocol version, payload: requested version
+  negotiate = 'n',
+  /// Interpolated bearing, payload: frequency (0 low, 1 high)
+  bearing = 'p',
+  /// Query the diode integration and settle timing
+  timing = 't',
+  /// Override the diode timing, payload: integration us, settle us (u16 LE)
+  set_timing = 'T',
+  /// Start a timing calibration
+  calibrate = 'k',
+  /// Select the sweep mode, payload: 0 sequential, 1 interleaved
+  sweep_mode = 'm',
+  /// Configure oversampling, payload: reading count, filter
+  oversampling = 'o',
+  /// Modeled sweep times of both sweep modes
+  benchmark = 'b',
+  /// High and low beacon reports and the camera block, see `snapshot`
+  snapshot = 's',
+  /// Push snapshots without being asked, payload: period ms (u16 LE), on
+  /// change (0 or 1). A period of 0 stops the pushes.
+  subscribe = 'u',
+  /// Switch the RS485 baud rate, payload: index into `baud_rates`
+  baud_rate = 'r',
+  /// Measured cost of reading the camera over the I2C backend in use
+  camera_benchmark = 'C',
+  /// Age of the camera result 'c' answers with, see `camera_age_version`
+  camera_age = 'g',
+  /// Every object of the latest camera result, payload: most objects to
+  /// return. See `camera_object`.
+  camera_objects = 'd',
+  /// Select the camera algorithm, payload: algorithm ID, see
+  /// `camera_algorithm`
+  camera_algorithm = 'A',
+  /// Camera resynchronisation counters, five u32 LE
+  camera_resync = 'R',
+  /// Adapter metrics, payload: 0 for the error counters, 0xFF for the shared
+  /// overflow histogram, otherwise the command whose latency histogram to
+  /// return
+  metrics = 'M',
+  /// Cost of the profiled firmware zones, payload: reset them afterwards (0 or
+  /// 1)
+  profile = 'P',
+  /// Framed reply to a rejected request, payload: the rejected command
+  nack = 0x15,
+};
+
+/**
+ * @brief Number of payload bytes a request carries
+ *
+ * @param p_command - request command
+ * @return std::size_t - payload length, not counting the legacy checksum. 0
+ * for commands without a payload and unknown commands.
+ */
+inline std::size_t
+payload_size(command p_command)
+{
+  switch (p_command) {
+    case command::negotiate:
+    case command::bearing:
+    case command::sweep_mode:
+    case command::baud_rate:
+    case command::camera_objects:
+    case command::camera_algorithm:
+    case command::metrics:
+    case command::profile:
+      return 1;
+    case command::oversampling:
+      return 2;
+    case command::subscribe:
+      return 3;
+    case command::set_timing:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+/// Original protocol, 'l' and 'h' reply with 3 bytes holding a 7-bit
+/// intensity with the frequency packed into its top bit.
+constexpr std::uint8_t legacy_version = 1;
+/// 'l' and 'h' reply with a `beacon_report`
+constexpr std::uint8_t compact_version = 2;
+/// Requests and responses may be wrapped in frames, see `frame`
+constexpr std::uint8_t framed_version = 3;
+/// The 's' command is available
+constexpr std::uint8_t snapshot_version = 4;
+/// The 'u' command is available. Pushed snapshots are always sent as frames
+/// with command 's' and a sequence number counting the pushes, with
+/// `pushed_sequence_flag` set.
+constexpr std::uint8_t streaming_version = 5;
+/// The 'r' command is available
+constexpr std::uint8_t baud_rate_version = 6;
+/// The 'g' command is available. The camera is read in the background and
+/// 'c' answers with the latest result without waiting for the camera.
+constexpr std::uint8_t camera_age_version = 7;
+/// The 'd' command is available
+constexpr std::uint8_t camera_objects_version = 8;
+/// The 'A' command is available
+constexpr std::uint8_t camera_algorithm_version = 9;
+/// The 'R' command is available
+constexpr std::uint8_t camera_resync_version = 10;
+/// The 'M' command is available
+constexpr std::uint8_t metrics_version = 11;
+/// The 'P' command is available
+constexpr std::uint8_t profile_version = 12;
+/// Latest protocol version known to this header
+constexpr std::uint8_t latest_version = profile_version;
+
+/**
+ * @brief Camera algorithms that can be selected with 'A'
+ *
+ * Any other ID is passed to the camera as it is. The adapter keeps the latest
+ * result of each recently selected algorithm apart, so after a switch the
+ * camera commands answer with an empty result until the new algorithm's first
+ * result has been read. The response echoes the ID twice.
+ */
+enum class camera_algorithm : std::uint8_t
+{
+  /// Results of whatever algorithm the camera runs, the default
+  any = 0,
+  /// Follow a single learned object
+  object_tracking = 3,
+};
+
+/**
+ * @brief Baud rates the RS485 link can be switched to with 'r'
+ *
+ * The link starts at the first rate. Switching takes two steps so that a rate
+ * that does not work can never strand the link:
+ *
+ * 1. The brain sends 'r' with the rate's index. The adapter acknowledges at
+ *    the current rate, then switches and starts a trial.
+ * 2. The brain switches and sends the same 'r' request at the new rate. The
+ *    adapter acknowledges it, which ends the trial.
+ *
+ * A trial that is not confirmed within `baud_rate_trial_ms` puts the adapter
+ * back on the first rate. A brain whose confirmation gets no answer goes back
+ * to the first rate as well.
+ *
+ * A confirmed rate is kept until the adapter is reset. A brain that restarts
+ * while the adapter stays powered starts on the first rate again, so a brain
+ * whose 'n' gets no answer tries every rate in `baud_rate_probe()` order.
+ */
+constexpr std::uint32_t baud_rates[] = { 115200, 230400, 460800, 921600 };
+/// Number of entries in `baud_rates`
+constexpr std::uint8_t baud_rate_count = 4;
+/// Time the brain has to confirm a new baud rate
+constexpr std::uint32_t baud_rate_trial_ms = 500;
+
+/**
+ * @brief Baud rate to try on an attempt to reach an adapter at an unknown rate
+ *
+ * The brain's current rate is tried first, then the first rate a reset adapter
+ * is on, then the others from the fastest down, since a brain that negotiated
+ * left the adapter on the fastest rate it could.
+ *
+ * @param p_current - index into `baud_rates` the brain is on
+ * @param p_attempt - 0 for the first attempt, up to `baud_rate_count` - 1
+ * @return std::uint8_t - index into `baud_rates` to try, every index is
+ * returned once over the attempts.
+ */
+constexpr std::uint8_t
+baud_rate_probe(std::uint8_t p_current, std::uint8_t p_attempt)
+{
+  if (p_attempt == 0) {
+    return p_current;
+  }
+  if (p_attempt == 1 && p_current != 0) {
+    return 0;
+  }
+  std::uint8_t tried = (p_current == 0) ? 1 : 2;
+  for (std::uint8_t index = baud_rate_count - 1; index > 0; index--) {
+    if (index == p_current) {
+      continue;
+    }
+    if (tried++ == p_attempt) {
+      return index;
+    }
+  }
+  return p_current;
+}
+
+/**
+ * @brief Response to the 'l' and 'h' commands from protocol version 2 onward
+ *
+ * Every field is a single byte so the struct has the same layout on the
+ * adapter and the brain and can be copied straight from the wire.
+ */
+struct beacon_report
+{
+  /// Value of `second_peak` when no second diode is known
+  static constexpr std::uint8_t no_diode = 0xFF;
+
+  /// Index of the strongest diode, 0 (left) to 7 (right)
+  std::uint8_t peak = 0;
+  /// Full 8-bit intensity of the strongest diode
+  std::uint8_t intensity = 0;
+  /// 0 for the low frequency channel, 1 for the high frequency channel
+  std::uint8_t frequency = 0;
+  /// Index of the second strongest diode
+  std::uint8_t second_peak = no_diode;
+  /// Full 8-bit intensity of the second strongest diode
+  std::uint8_t second_intensity = 0;
+  /// Sum of the previous bytes
+  std::uint8_t checksum = 0;
+};
+
+static_assert(sizeof(beacon_report) == 6, "beacon_report must not be padded");
+
+/**
+ * @brief Calculate the checksum of a beacon report
+ *
+ * @param p_report - report to calculate the checksum of
+ * @return constexpr std::uint8_t - 8-bit sum of every field but the checksum
+ */
+constexpr std::uint8_t
+checksum(beacon_report const& p_report)
+{
+  return static_cast<std::uint8_t>(p_report.peak + p_report.intensity +
+                                   p_report.frequency + p_report.second_peak +
+                                   p_report.second_intensity);
+}
+
+/**
+ * @brief Serialize a beacon report to its wire format
+ *
+ * @param p_report - report to serialize
+ * @return constexpr std::array<std::uint8_t, sizeof(beacon_report)> - bytes
+ */
+constexpr std::array<std::uint8_t, sizeof(beacon_report)>
+to_bytes(beacon_report const& p_report)
+{
+  return {
+    p_report.peak,        p_report.intensity,        p_report.frequency,
+    p_report.second_peak, p_report.second_intensity, p_report.checksum,
+  };
+}
+
+/**
+ * @brief Response to the 's' command
+ *
+ * Holds everything the brain samples in one response so a refresh takes one
+ * round trip instead of three.
+ */
+struct snapshot
+{
+  /// Latest high frequency report, as returned by 'h'
+  beacon_report high;
+  /// Latest low frequency report, as returned by 'l'
+  beacon_report low;
+  /// Camera block, as returned by 'c' without its checksum
+  std::array<std::uint8_t, 8> camera;
+  /// Sum of the previous bytes
+  std::uint8_t checksum;
+};
+
+static_assert(sizeof(snapshot) == 21, "snapshot must not be padded");
+
+/// Most objects a 'd' response can hold
+constexpr std::uint8_t max_camera_objects = 6;
+
+/**
+ * @brief One object of a 'd' response
+ *
+ * A 'd' request carries the most objects to return, from 1 to
+ * `max_camera_objects`. The response is a count byte followed by that many
+ * `camera_object` entries and a checksum, so its length only depends on the
+ * request. Entries past the count are zero.
+ */
+struct camera_object
+{
+  /// Value of `kind` for a bounding box
+  static constexpr std::uint8_t block = 0;
+  /// Value of `kind` for a line, such as one found by line tracking
+  static constexpr std::uint8_t arrow = 1;
+
+  /// ID the camera learned the object as, 0 if it was not learned
+  std::uint8_t id = 0;
+  /// `block` or `arrow`
+  std::uint8_t kind = block;
+  /// For a block: x center, y center, width and height. For an arrow: x and y
+  /// of the origin followed by x and y of the target. Each value is 16-bit,
+  /// low byte first, in pixels.
+  std::array<std::uint8_t, 8> geometry{};
+};
+
+static_assert(sizeof(camera_object) == 10, "camera_object must not be padded");
+
+/**
+ * @brief Number of bytes in a 'd' response
+ *
+ * @param p_requested - most objects requested
+ * @return constexpr std::size_t - count, objects and checksum
+ */
+constexpr std::size_t camera_objects_size(std::uint8_t p_requested)
+{
+  return 1 + p_requested * sizeof(camera_object) + 1;
+}
+
+/// First byte of every frame, never used as a command byte
+constexpr std::uint8_t frame_sync = 0xA5;
+/// Largest payload a frame may carry
+constexpr std::size_t max_payload_size = 128;
+/// Bytes a frame adds around its payload: sync, length, sequence, command and
+/// the two CRC bytes.
+constexpr std::size_t frame_overhead = 6;
+/// Largest encoded frame
+constexpr std::size_t max_frame_size = max_payload_size + frame_overhead;
+/// Initial value of the frame CRC
+constexpr std::uint16_t crc16_initial = 0xFFFF;
+/// Set in the sequence number of every pushed snapshot. Requests number their
+/// frames without it, so a pushed frame is never taken for a response.
+constexpr std::uint8_t pushed_sequence_flag = 0x80;
+
+/**
+ * @brief Continue a CRC-16/CCITT-FALSE over more bytes
+ *
+ * @param p_data - bytes to add to the CRC
+ * @param p_length - number of bytes in p_data
+ * @param p_crc - CRC of the bytes before p_data
+ * @return std::uint16_t - CRC including p_data
+ */
+inline std::uint16_t
+crc16(std::uint8_t const* p_data,
+      std::size_t p_length,
+      std::uint16_t p_crc = crc16_initial)
+{
+  for (std::size_t i = 0; i < p_length; i++) {
+    p_crc ^= static_cast<std::uint16_t>(p_data[i] << 8);
+    for (int bit = 0; bit < 8; bit++) {
+      bool const carry = (p_crc & 0x8000) != 0;
+      p_crc = static_cast<std::uint16_t>(p_crc << 1);
+      if (carry) {
+        p_crc ^= 0x1021;
+      }
+    }
+  }
+  return p_crc;
+}
+
+/**
+ * @brief A request or response of the framed protocol
+ *
+ * On the wire a frame is laid out as:
+ *
+ *     [sync][length][sequence][command][payload...][crc low][crc high]
+ *
+ * `length` counts only the payload. The CRC covers every byte from `length`
+ * to the end of the payload. A response carries the sequence number and
+ * command of its request and the same bytes, checksum included, that the
+ * unframed command would have replied with.
+ */
+struct frame
+{
+  /// Request counter chosen by the brain and echoed by the adapter
+  std::uint8_t sequence = 0;
+  /// Command byte, see `command`
+  std::uint8_t command = 0;
+  /// Number of valid bytes in `payload`
+  std::uint8_t length = 0;
+  std::array<std::uint8_t, max_payload_size> payload{};
+};
+
+/**
+ * @brief Encode a frame into a buffer
+ *
+ * @param p_sequence - sequence number of the frame
+ * @param p_command - command byte of the frame
+ * @param p_payload - payload bytes
+ * @param p_length - number of payload bytes, at most max_payload_size
+ * @param p_output - buffer of at least p_length + frame_overhead bytes
+ * @return std::size_t - number of bytes written to p_output
+ */
+inline std::size_t
+encode_frame(std::uint8_t p_sequence,
+             std::uint8_t p_command,
+             std::uint8_t const* p_payload,
+             std::size_t p_length,
+             std::uint8_t* p_output)
+{
+  p_output[0] = frame_sync;
+  p_output[1] = static_cast<std::uint8_t>(p_length);
+  p_output[2] = p_sequence;
+  p_output[3] = p_command;
+  for (std::size_t i = 0; i < p_length; i++) {
+    p_output[4 + i] = p_payload[i];
+  }
+  auto const crc = crc16(p_output + 1, p_length + 3);
+  p_output[4 + p_length] = static_cast<std::uint8_t>(crc & 0xFF);
+  p_output[5 + p_length] = static_cast<std::uint8_t>(crc >> 8);
+  return p_length + frame_overhead;
+}
+
+/**
+ * @brief Streaming decoder of frames
+ *
+ * Bytes are pushed in as they arrive and may split a frame at any point. A
+ * frame with a bad length or CRC only costs its sync byte: the parser searches
+ * the bytes it already holds for the next sync byte, so a frame that arrived
+ * right behind a damaged one is still decoded.
+ *
+ * Call next() after every push() until it returns false.
+ */
+class frame_parser
+{
+public:
+  /**
+   * @brief Add a received byte
+   *
+   * @param p_byte - byte from the link
+   */
+  void push(std::uint8_t p_byte)
+  {
+    if (m_size == 0 && p_byte != frame_sync) {
+      m_discarded++;
+      return;
+    }
+    if (m_size == m_buffer.size()) {
+      drop(1);
+    }
+    m_buffer[m_size++] = p_byte;
+  }
+
+  /**
+   * @brief Take the next complete frame out of the parser
+   *
+   * @param p_frame - filled with the frame if one is complete
+   * @return true - p_frame holds a frame with a valid CRC
+   */
+  bool next(frame& p_frame)
+  {
+    while (m_size >= 2) {
+      std::size_t const length = m_buffer[1];
+      if (length > max_payload_size) {
+        drop(1);
+        continue;
+      }
+
+      std::size_t const total = length + frame_overhead;
+      if (m_size < total) {
+        return false;
+      }
+
+      auto const crc = crc16(m_buffer.data() + 1, length + 3);
+      auto const received = static_cast<std::uint16_t>(
+        m_buffer[total - 2] | (m_buffer[total - 1] << 8));
+      if (crc != received) {
+        m_crc_errors++;
+        drop(1);
+        continue;
+      }
+
+      p_frame.length = static_cast<std::uint8_t>(length);
+      p_frame.sequence = m_buffer[2];
+      p_frame.command = m_buffer[3];
+      for (std::size_t i = 0; i < length; i++) {
+        p_frame.payload[i] = m_buffer[4 + i];
+      }
+      drop(total);
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Determine if part of a frame has been received
+   *
+   * @return true - bytes following a sync byte are held by the parser
+   */
+  bool in_frame() const { return m_size != 0; }
+
+  /**
+   * @brief Abandon the partially received frame
+   *
+   * The bytes held are counted as discarded.
+   */
+  void reset()
+  {
+    m_discarded += static_cast<std::uint32_t>(m_size);
+    m_size = 0;
+  }
+
+  /**
+   * @brief Number of frames rejected because of a CRC mismatch
+   *
+   * @return std::uint32_t - CRC errors since construction
+   */
+  std::uint32_t crc_errors() const { return m_crc_errors; }
+
+  /**
+   * @brief Number of bytes skipped while searching for a sync byte
+   *
+   * @return std::uint32_t - discarded bytes since construction
+   */
+  std::uint32_t discarded() const { return m_discarded; }
+
+private:
+  // Remove p_count bytes from the front then skip ahead to the next sync byte
+  void drop(std::size_t p_count)
+  {
+    std::size_t start = p_count;
+    while (start < m_size && m_buffer[start] != frame_sync) {
+      start++;
+    }
+    m_discarded += static_cast<std::uint32_t>(start - p_count);
+    for (std::size_t i = start; i < m_size; i++) {
+      m_buffer[i - start] = m_buffer[i];
+    }
+    m_size -= start;
+  }
+
+  std::array<std::uint8_t, max_frame_size> m_buffer{};
+  std::size_t m_size = 0;
+  std::uint32_t m_crc_errors = 0;
+  std::uint32_t m_discarded = 0;
+};
+} // namespace protocol
+} // namespace e10
+
+#pragma endregion E10 Protocol
+
 namespace e10 {
 /**
  * @brief Hardware abstraction adapter for the E10 IRB sensor board.
@@ -86,17 +633,36 @@ public:
    * @brief A single infrared beacon measurement from one of the IR receivers.
    *
    * Each measurement contains the direction of the strongest detected IR signal
-   * (which photo diode fired) and the intensity of that signal. The raw byte
-   * array is populated by the adapter's background thread via a serial request
-   * to the E10 board.
+   * (which photo diode fired) and the intensity of that signal. The report is
+   * populated by the adapter's background thread via a serial request to the
+   * E10 board.
    */
   struct ir_measurement
   {
-    // Photo diode command byte indicies
+    // Photo diode command byte indicies of the legacy 3-byte response
     static constexpr auto diode_number = 0;
     static constexpr auto intensity_value = 1;
     static constexpr auto max_intensity_mask = static_cast<uint8_t>(~(1U << 7));
 
+    /**
+     * @brief Decode the 3-byte response of adapters using protocol version 1.
+     *
+     * The 7-bit intensity is scaled up to the full 8-bit range. The second
+     * strongest diode is not known.
+     *
+     * @param p_raw - legacy response bytes
+     * @return ir_measurement - decoded measurement
+     */
+    static ir_measurement from_legacy(std::array<uint8_t, 3> const& p_raw)
+    {
+      ir_measurement measurement;
+      measurement.report.peak = p_raw[diode_number];
+      auto const intensity = p_raw[intensity_value] & max_intensity_mask;
+      measurement.report.intensity = static_cast<uint8_t>(intensity << 1);
+      measurement.report.frequency = p_raw[intensity_value] >> 7;
+      return measurement;
+    }
+
     /**
      * @brief Minimum valid direction index (leftmost photo diode).
      * @return int - always 0
@@ -130,7 +696,7 @@ public:
      *
      * @return int - direction index in [0, 7]
      */
-    int direction() const noexcept { return raw[diode_number]; }
+    int direction() const noexcept { return report.peak; }
 
     /**
      * @brief Strength of the detected IR signal.
@@ -141,22 +707,49 @@ public:
      *
      * @return int - signal intensity in [0, 127]
      */
-    int intensity() const noexcept
+    int intensity() const noexcept { return report.intensity >> 1; }
+
+    /**
+     * @brief Strength of the detected IR signal at full resolution.
+     *
+     * Adapters that only speak protocol version 1 report 7 bits, in which case
+     * the value is always even.
+     *
+     * @return int - signal intensity in [0, 255]
+     */
+    int full_intensity() const noexcept { return report.intensity; }
+
+    /**
+     * @brief Index of the photo diode with the second strongest IR signal.
+     *
+     * @return int - direction index in [0, 7] or -1 if the adapter did not
+     * report it.
+     */
+    int second_direction() const noexcept
     {
-      return raw[intensity_value] & max_intensity_mask;
+      if (report.second_peak == protocol::beacon_report::no_diode) {
+        return -1;
+      }
+      return report.second_peak;
     }
 
+    /**
+     * @brief Strength of the second strongest IR signal at full resolution.
+     * @return int - signal intensity in [0, 255]
+     */
+    int second_intensity() const noexcept { return report.second_intensity; }
+
     /**
      * @brief Equality comparison against another measurement.
      * @param other - measurement to compare against
-     * @return true if every byte of the raw payload matches
+     * @return true if every byte of the report matches
      */
     bool operator==(const ir_measurement& other) const noexcept
     {
-      return raw == other.raw;
+      return protocol::to_bytes(report) == protocol::to_bytes(other.report);
     }
 
-    std::array<uint8_t, 3> raw{};
+    protocol::beacon_report report{};
   };
 
   /**
@@ -229,18 +822,111 @@ public:
       return (raw[block_height_hi] << 8) | raw[block_height_low];
     }
 
+    /**
+     * @brief ID the camera learned the object as.
+     *
+     * Only known for objects returned by `get_detected_objects()` from
+     * adapters using protocol version 8 or newer.
+     *
+     * @return int - learned ID, 0 if the object was not learned
+     */
+    int id() const noexcept { return object_id; }
+
+    /**
+     * @brief Determine if the object is an arrow instead of a bounding box.
+     *
+     * For an arrow, `x_center()` and `y_center()` hold the origin of the arrow
+     * and `width()` and `height()` hold the x and y of its target.
+     *
+     * @return true if the camera reported an arrow
+     */
+    bool is_arrow() const noexcept
+    {
+      return kind == protocol::camera_object::arrow;
+    }
+
     /**
      * @brief Equality comparison against another detected_object.
      * @param other - object to compare against
-     * @return true if every byte of the raw payload matches
+     * @return true if every byte of the raw payload, the ID and the kind match
      */
     bool operator==(const detected_object& other) const
     {
-      return raw == other.raw;
+      return raw == other.raw and object_id == other.object_id and
+             kind == other.kind;
     }
 
     using data_array = std::array<uint8_t, 9>;
     data_array raw{};
+    uint8_t object_id = 0;
+    uint8_t kind = protocol::camera_object::block;
+  };
+
+  /**
+   * @brief Every object of the latest camera result, up to a fixed capacity.
+   *
+   * Iterate it like a container to pick the object that suits the mission,
+   * such as the nearest one (largest `width()`).
+   */
+  struct detected_objects
+  {
+    /**
+     * @brief Number of objects detected.
+     * @return size_t - objects in [0, protocol::max_camera_objects]
+     */
+    size_t size() const noexcept { return count; }
+
+    /**
+     * @brief Determine if nothing was detected.
+     * @return true if there are no objects
+     */
+    bool empty() const noexcept { return count == 0; }
+
+    detected_object const* begin() const noexcept { return objects.data(); }
+    detected_object const* end() const noexcept
+    {
+      return objects.data() + count;
+    }
+
+    /**
+     * @brief Access one of the objects.
+     * @param p_index - index below size()
+     * @return detected_object const& - the object
+     */
+    detected_object const& operator[](size_t p_index) const
+    {
+      return objects[p_index];
+    }
+
+    /**
+     * @brief Equality comparison against another set of objects.
+     * @param other - objects to compare against
+     * @return true if both hold the same objects
+     */
+    bool operator==(const detected_objects& other) const
+    {
+      return count == other.count and
+             std::equal(begin(), end(), other.begin());
+    }
+
+    std::array<detected_object, protocol::max_camera_objects> objects{};
+    size_t count = 0;
+  };
+
+  /**
+   * @brief How the background thread refreshes the cached measurements.
+   */
+  enum class request_mode
+  {
+    /// One request each for the high beacon, the camera and the low beacon.
+    individual,
+    /// A single request returning everything at once. Falls back to
+    /// `individual` if the adapter's firmware does not support it.
+    batched,
+    /// The adapter pushes everything whenever a new sweep completes, without
+    /// being asked. Falls back to `batched` if the adapter's firmware does not
+    /// support it.
+    streaming,
   };
 
   /**
@@ -252,10 +938,12 @@ public:
    *
    * @param p_port - VEX smart port number (1–21) the E10 adapter is plugged
    * into
+   * @param p_mode - how the measurements are requested from the adapter
    */
-  adapter(uint8_t p_port)
-    : m_sampling_thread(sampling_thread, this)
+  adapter(uint8_t p_port, request_mode p_mode = request_mode::batched)
+    : m_mode(p_mode)
     , m_port(p_port)
+    , m_sampling_thread(sampling_thread, this)
   {
   }
 
@@ -320,6 +1008,46 @@ public:
     return result1;
   }
 
+  /**
+   * @brief Return every object of the latest camera result.
+   *
+   * Reads from a cache that is updated by the background sampling thread.
+   * Uses the same torn-write guard as `measure_1kHz()`. Adapters older than
+   * protocol version 8 and the `streaming` mode only report the first block.
+   *
+   * The sampling thread only asks the adapter for every object once this has
+   * been called, so programs that never call it pay nothing for it. Until the
+   * first answer arrives, only the first block is reported.
+   *
+   * @return detected_objects - most recent camera objects
+   */
+  detected_objects get_detected_objects()
+  {
+    m_objects_wanted = true;
+    detected_objects result1, result2;
+    do {
+      result1 = m_cached_objects;
+      result2 = m_cached_objects;
+    } while (not(result1 == result2));
+
+    return result1;
+  }
+
+  /**
+   * @brief Select the algorithm the camera runs.
+   *
+   * The background sampling thread passes the selection on to the adapter.
+   * Until the first result of the new algorithm arrives, the camera results
+   * are empty rather than left over from the previous algorithm. Adapters
+   * older than protocol version 9 keep running their current algorithm.
+   *
+   * @param p_algorithm - algorithm to run
+   */
+  void set_camera_algorithm(protocol::camera_algorithm p_algorithm)
+  {
+    m_requested_algorithm = static_cast<uint8_t>(p_algorithm);
+  }
+
   ~adapter() { fclose(m_port_file); }
 
 private:
@@ -351,6 +1079,7 @@ private:
       m_cached_low = {};
       m_cached_high = {};
       m_cached_camera = {};
+      m_cached_objects = {};
 
       // Attempt to open port ==================================================
 
@@ -368,17 +1097,35 @@ private:
       }
     }
 
+    negotiate_protocol();
+
     while (true) {
+      apply_camera_algorithm();
+
+      if (m_mode == request_mode::streaming and
+          m_protocol_version >= protocol::streaming_version) {
+        receive_stream();
+        continue;
+      }
+
+      if (m_mode != request_mode::individual and
+          m_protocol_version >= protocol::snapshot_version) {
+        request_snapshot();
+        refresh_objects();
+        vex::wait(10, msec);
+        continue;
+      }
+
       // =======================================================================
       // --- High Buffer Processing ---
       // =======================================================================
       {
-        auto const buffer = request_data<sizeof(ir_measurement)>('h');
-        if (buffer.valid) {
-          // NOTE: this 3-byte assignment is not atomic. measure_10kHz() must
-          // double check the result for information tearing before returning
-          // the value.
-          m_cached_high.raw = buffer.data;
+        ir_measurement measurement;
+        if (request_measurement(protocol::command::high, measurement)) {
+          // NOTE: this multi-byte assignment is not atomic. measure_10kHz()
+          // must double check the result for information tearing before
+          // returning the value.
+          m_cached_high = measurement;
         }
         vex::wait(10, msec);
       }
@@ -387,25 +1134,28 @@ private:
       // --- Camera Buffer Processing ---
       // =======================================================================
       {
-        auto const buffer = request_data<sizeof(detected_object)>('c');
+        constexpr auto block_size =
+          std::tuple_size<detected_object::data_array>::value;
+        auto const buffer = request_data<block_size>('c');
         if (buffer.valid) {
           // NOTE: this 9-byte assignment is not atomic. get_detected_object()
           // must double check the result for information tearing before
           // returning the value.
           m_cached_camera.raw = buffer.data;
         }
+        refresh_objects();
         vex::wait(10, msec);
       }
       // =======================================================================
       // --- Low Buffer Processing ---
       // =======================================================================
       {
-        auto const buffer = request_data<sizeof(ir_measurement)>('l');
-        if (buffer.valid) {
-          // NOTE: this 3-byte assignment is not atomic. measure_1kHz() must
-          // double check the result for information tearing before returning
-          // the value.
-          m_cached_low.raw = buffer.data;
+        ir_measurement measurement;
+        if (request_measurement(protocol::command::low, measurement)) {
+          // NOTE: this multi-byte assignment is not atomic. measure_1kHz()
+          // must double check the result for information tearing before
+          // returning the value.
+          m_cached_low = measurement;
         }
         vex::wait(10, msec);
       }
@@ -432,8 +1182,322 @@ private:
     printf("]\n");
   }
 
+  /**
+   * @brief Ask the adapter for the newest protocol version both sides know.
+   *
+   * Adapters that predate negotiation never answer, leaving the link on
+   * protocol version 1. Without an answer every baud rate is tried, see
+   * protocol::baud_rate_probe().
+   */
+  void negotiate_protocol()
+  {
+    m_protocol_version = protocol::legacy_version;
+    std::array<uint8_t, 1> const requested = { protocol::latest_version };
+    auto const command = static_cast<char>(protocol::command::negotiate);
+    auto response = request_data<2>(command, requested);
+    // A reset adapter is back on the default baud rate, one that stayed
+    // powered while this program restarted is still on the negotiated rate
+    auto const current = m_baud_rate_index;
+    for (uint8_t attempt = 1;
+         not response.valid and attempt < protocol::baud_rate_count;
+         attempt++) {
+      set_baud_rate(protocol::baud_rate_probe(current, attempt));
+      response = request_data<2>(command, requested);
+    }
+    if (response.valid) {
+      m_protocol_version = response.data[0];
+    } else {
+      // Adapters that predate negotiation only run at the default rate
+      set_baud_rate(0);
+    }
+    printf("Protocol version %u\n", m_protocol_version);
+    // A reset adapter is back on the default algorithm
+    m_applied_algorithm = static_cast<uint8_t>(protocol::camera_algorithm::any);
+
+    if (m_protocol_version >= protocol::baud_rate_version and
+        m_baud_rate_index != preferred_baud_rate_index) {
+      negotiate_baud_rate();
+    }
+  }
+
+  /**
+   * @brief Move the link to `preferred_baud_rate_index`.
+   *
+   * The adapter acknowledges the request at the current rate, then both sides
+   * switch and the request is repeated at the new rate to confirm it. If the
+   * confirmation gets no answer, both sides go back to the default rate.
+   */
+  void negotiate_baud_rate()
+  {
+    std::array<uint8_t, 1> const index = { preferred_baud_rate_index };
+    auto const command = static_cast<char>(protocol::command::baud_rate);
+    if (not request_data<2>(command, index).valid) {
+      return;
+    }
+
+    set_baud_rate(preferred_baud_rate_index);
+    if (not request_data<2>(command, index).valid) {
+      // The adapter reverts on its own once the confirmation is overdue
+      set_baud_rate(0);
+      vex::wait(protocol::baud_rate_trial_ms, msec);
+    }
+    printf("Baud rate %lu\n",
+           static_cast<unsigned long>(protocol::baud_rates[m_baud_rate_index]));
+  }
+
+  /**
+   * @brief Change the baud rate of the smart port.
+   *
+   * @param p_index - index into protocol::baud_rates
+   */
+  void set_baud_rate(uint8_t p_index)
+  {
+    vexGenericSerialBaudrate(m_port - 1, protocol::baud_rates[p_index]);
+    m_baud_rate_index = p_index;
+  }
+
+  /**
+   * @brief Request a beacon measurement in the negotiated response format.
+   *
+   * A failed response may mean the adapter was reset and forgot the
+   * negotiated version, so the version is negotiated again.
+   *
+   * @param p_command - protocol::command::low or protocol::command::high
+   * @param p_measurement - updated with the measurement on success
+   * @return true if a valid response was received
+   */
+  bool request_measurement(protocol::command p_command,
+                           ir_measurement& p_measurement)
+  {
+    auto const command = static_cast<char>(p_command);
+
+    if (m_protocol_version >= protocol::compact_version) {
+      constexpr auto report_size = sizeof(protocol::beacon_report);
+      auto const buffer = request_data<report_size>(command);
+      if (not buffer.valid) {
+        negotiate_protocol();
+        return false;
+      }
+      memcpy(&p_measurement.report, buffer.data.data(), buffer.data.size());
+      return true;
+    }
+
+    auto const buffer = request_data<3>(command);
+    if (not buffer.valid) {
+      return false;
+    }
+    p_measurement = ir_measurement::from_legacy(buffer.data);
+    return true;
+  }
+
+  /**
+   * @brief Refresh every cached value with a single request.
+   *
+   * A failed response may mean the adapter was reset and forgot the
+   * negotiated version, so the version is negotiated again.
+   */
+  void request_snapshot()
+  {
+    auto const command = static_cast<char>(protocol::command::snapshot);
+    auto const buffer = request_data<sizeof(protocol::snapshot)>(command);
+    if (not buffer.valid) {
+      negotiate_protocol();
+      return;
+    }
+
+    store_snapshot(buffer.data.data());
+  }
+
+  /**
+   * @brief Subscribe to pushed snapshots and cache them as they arrive.
+   *
+   * Returns once no snapshot has arrived for `stream_timeout_ms`, which means
+   * the adapter was reset and forgot the subscription, after negotiating the
+   * protocol version again.
+   */
+  void receive_stream()
+  {
+    std::array<uint8_t, 3> const subscription = { stream_period_ms, 0, 1 };
+    auto const command = static_cast<char>(protocol::command::subscribe);
+    if (not request_data<4>(command, subscription).valid) {
+      negotiate_protocol();
+      return;
+    }
+
+    protocol::frame frame;
+    std::array<uint8_t, 32> received{};
+    for (int idle_ms = 0; idle_ms < stream_timeout_ms; idle_ms++) {
+      if (m_requested_algorithm != m_applied_algorithm) {
+        // Let the sampling loop switch the algorithm, then subscribe again
+        return;
+      }
+      vex::wait(1, msec);
+      auto const bytes_read = fread(received.data(),
+                                    sizeof(received[0]),
+                                    received.size(),
+                                    m_port_file);
+      for (size_t i = 0; i < bytes_read; i++) {
+        m_parser.push(received[i]);
+        while (m_parser.next(frame)) {
+          if (frame.command == static_cast<uint8_t>(protocol::command::snapshot)
+              and frame.length == sizeof(protocol::snapshot)) {
+            store_snapshot(frame.payload.data());
+            idle_ms = 0;
+          }
+        }
+      }
+    }
+
+    printf("Snapshot stream stopped\n");
+    negotiate_protocol();
+  }
+
+  /**
+   * @brief Update every cached value from a snapshot response.
+   *
+   * @param p_bytes - sizeof(protocol::snapshot) bytes from the wire
+   */
+  void store_snapshot(uint8_t const* p_bytes)
+  {
+    protocol::snapshot snapshot;
+    memcpy(&snapshot, p_bytes, sizeof(snapshot));
+
+    ir_measurement high;
+    high.report = snapshot.high;
+    ir_measurement low;
+    low.report = snapshot.low;
+    detected_object camera;
+    uint8_t camera_checksum = 0;
+    for (size_t i = 0; i < snapshot.camera.size(); i++) {
+      camera.raw[i] = snapshot.camera[i];
+      camera_checksum += snapshot.camera[i];
+    }
+    camera.raw[snapshot.camera.size()] = camera_checksum;
+
+    // NOTE: these assignments are not atomic. The measure functions must
+    // double check the result for information tearing before returning the
+    // value.
+    m_cached_high = high;
+    m_cached_low = low;
+    m_cached_camera = camera;
+    if (m_mode == request_mode::streaming) {
+      m_cached_objects = objects_from_block(camera);
+    }
+  }
+
+  /**
+   * @brief Pass the algorithm selected with `set_camera_algorithm()` on to
+   * the adapter.
+   *
+   * The cached camera results are cleared on a switch so that a result of the
+   * previous algorithm is never returned for the new one.
+   */
+  void apply_camera_algorithm()
+  {
+    uint8_t const requested = m_requested_algorithm;
+    if (requested == m_applied_algorithm or
+        m_protocol_version < protocol::camera_algorithm_version) {
+      return;
+    }
+
+    std::array<uint8_t, 1> const algorithm = { requested };
+    auto const command = static_cast<char>(protocol::command::camera_algorithm);
+    if (not request_data<2>(command, algorithm).valid) {
+      return;
+    }
+
+    m_applied_algorithm = requested;
+    m_cached_camera = {};
+    m_cached_objects = {};
+  }
+
+  /**
+   * @brief Update the cached objects.
+   *
+   * Adapters older than protocol version 8 only report the first block, which
+   * was cached already. So do the others until `get_detected_objects()` is
+   * first called. After that, every object is requested at most once every
+   * `objects_refresh_ms`, so the extra request does not double the requests
+   * of each sampling cycle.
+   */
+  void refresh_objects()
+  {
+    if (m_protocol_version < protocol::camera_objects_version or
+        not m_objects_wanted) {
+      m_cached_objects = objects_from_block(m_cached_camera);
+      return;
+    }
+    if (m_objects_timer.time(msec) < objects_refresh_ms) {
+      return;
+    }
+    m_objects_timer.clear();
+
+    constexpr auto capacity = protocol::max_camera_objects;
+    std::array<uint8_t, 1> const requested = { capacity };
+    auto const command = static_cast<char>(protocol::command::camera_objects);
+    auto const buffer =
+      request_data<protocol::camera_objects_size(capacity)>(command,
+                                                             requested);
+    if (not buffer.valid) {
+      return;
+    }
+
+    detected_objects objects;
+    objects.count = std::min<size_t>(buffer.data[0], capacity);
+    for (size_t i = 0; i < objects.count; i++) {
+      auto const* entry = &buffer.data[1 + i * sizeof(protocol::camera_object)];
+      auto& object = objects.objects[i];
+      object.object_id = entry[0];
+      object.kind = entry[1];
+      uint8_t checksum = 0;
+      for (size_t byte = 0; byte < object.raw.size() - 1; byte++) {
+        object.raw[byte] = entry[2 + byte];
+        checksum += entry[2 + byte];
+      }
+      object.raw.back() = checksum;
+    }
+
+    // NOTE: this assignment is not atomic. get_detected_objects() must double
+    // check the result for information tearing before returning the value.
+    m_cached_objects = objects;
+  }
+
+  /**
+   * @brief Wrap a single camera block in a set of objects.
+   *
+   * @param p_block - block as returned by 'c'
+   * @return detected_objects - the block, or nothing if its width is 0
+   */
+  static detected_objects objects_from_block(detected_object const& p_block)
+  {
+    detected_objects objects;
+    if (p_block.width() != 0) {
+      objects.objects[0] = p_block;
+      objects.count = 1;
+    }
+    return objects;
+  }
+
+  /// Least time between two pushed snapshots, requested when subscribing
+  static constexpr uint8_t stream_period_ms = 10;
+  /// Time without a pushed snapshot after which the stream is restarted
+  static constexpr int stream_timeout_ms = 500;
+  /// Baud rate the link is moved to when the adapter supports it
+  static constexpr uint8_t preferred_baud_rate_index = 3;
+  /// Least time between two requests for every camera object, the camera
+  /// produces about 30 results per second
+  static constexpr int objects_refresh_ms = 33;
+
   template<size_t ObjectSize>
   request_response<ObjectSize> request_data(char p_command)
+  {
+    return request_data<ObjectSize>(p_command, std::array<uint8_t, 0>{});
+  }
+
+  template<size_t ObjectSize, size_t PayloadSize>
+  request_response<ObjectSize> request_data(
+    char p_command,
+    std::array<uint8_t, PayloadSize> const& p_payload)
   {
     static_assert(ObjectSize >= 2,
                   "ObjectSize must be equal to or greater than 1.");
@@ -444,9 +1508,25 @@ private:
       return false;
     }
 
+    if (m_protocol_version >= protocol::framed_version) {
+      return request_frame<ObjectSize>(
+        p_command, p_payload.data(), PayloadSize);
+    }
+
+    // Command byte, followed by the payload and its checksum if there is one
+    std::array<uint8_t, PayloadSize + 2> request{};
+    request[0] = static_cast<uint8_t>(p_command);
+    uint8_t payload_checksum = 0;
+    for (size_t i = 0; i < PayloadSize; i++) {
+      request[i + 1] = p_payload[i];
+      payload_checksum += p_payload[i];
+    }
+    request[PayloadSize + 1] = payload_checksum;
+    size_t const request_length = (PayloadSize == 0) ? 1 : request.size();
+
     auto const bytes_written =
-      fwrite(&p_command, sizeof(p_command), 1, m_port_file);
-    if (bytes_written != sizeof(p_command)) {
+      fwrite(request.data(), sizeof(request[0]), request_length, m_port_file);
+    if (bytes_written != request_length) {
       printf("Failed write to port, %zu bytes written.\n", bytes_written);
       return false;
     }
@@ -497,12 +1577,100 @@ private:
     return response;
   }
 
+  /**
+   * @brief Send a request as a frame and wait for its response frame.
+   *
+   * Every request gets the next sequence number. Late responses to earlier
+   * requests carry an older sequence number and are skipped, as are pushed
+   * snapshots. A partial frame
+   * stays in the parser until the rest of it arrives, so nothing has to be
+   * flushed after a timeout.
+   *
+   * @param p_command - command byte
+   * @param p_payload - request payload
+   * @param p_length - number of bytes in the payload
+   * @return request_response<ObjectSize> - response payload, valid if the
+   * adapter answered the request with ObjectSize bytes.
+   */
+  template<size_t ObjectSize>
+  request_response<ObjectSize> request_frame(char p_command,
+                                             uint8_t const* p_payload,
+                                             size_t p_length)
+  {
+    request_response<ObjectSize> response{};
+    auto const command = static_cast<uint8_t>(p_command);
+    // Pushed snapshots have the flag set, requests never do
+    m_sequence = static_cast<uint8_t>((m_sequence + 1) %
+                                      protocol::pushed_sequence_flag);
+
+    std::array<uint8_t, protocol::max_frame_size> request{};
+    auto const request_length = protocol::encode_frame(
+      m_sequence, command, p_payload, p_length, request.data());
+    auto const bytes_written =
+      fwrite(request.data(), sizeof(request[0]), request_length, m_port_file);
+    if (bytes_written != request_length) {
+      printf("Failed write to port, %zu bytes written.\n", bytes_written);
+      return false;
+    }
+
+    constexpr auto snapshot = static_cast<uint8_t>(protocol::command::snapshot);
+    protocol::frame frame;
+    std::array<uint8_t, 16> received{};
+    for (int attempts = 0; attempts < 100 and not response.valid; attempts++) {
+      vex::wait(1, msec);
+      auto const bytes_read = fread(received.data(),
+                                    sizeof(received[0]),
+                                    received.size(),
+                                    m_port_file);
+      for (size_t i = 0; i < bytes_read; i++) {
+        m_parser.push(received[i]);
+        while (m_parser.next(frame)) {
+          // Skip late responses and snapshots pushed while subscribed,
+          // including those of adapters that predate pushed_sequence_flag
+          if (frame.sequence != m_sequence or
+              (frame.command == snapshot and command != snapshot)) {
+            continue;
+          }
+          if (frame.command != command or frame.length != ObjectSize) {
+            printf("Command '%c' rejected by the adapter\n", p_command);
+            return false;
+          }
+          std::copy(frame.payload.begin(),
+                    frame.payload.begin() + ObjectSize,
+                    response.data.begin());
+          response.valid = true;
+        }
+      }
+    }
+
+    if (not response.valid) {
+      printf("Command '%c' frame %u timed out\n", p_command, m_sequence);
+    }
+    return response;
+  }
+
   FILE* m_port_file = nullptr;
-  vex::thread m_sampling_thread;
+  request_mode m_mode;
+  /// Written by `set_camera_algorithm()`, read by the sampling thread
+  uint8_t volatile m_requested_algorithm =
+    static_cast<uint8_t>(protocol::camera_algorithm::any);
   detected_object m_cached_camera{};
+  detected_objects m_cached_objects{};
   ir_measurement m_cached_high{};
   ir_measurement m_cached_low{};
   uint8_t m_port{};
+  protocol::frame_parser m_parser;
+  uint8_t m_protocol_version = protocol::legacy_version;
+  uint8_t m_sequence = 0;
+  uint8_t m_baud_rate_index = 0;
+  uint8_t m_applied_algorithm =
+    static_cast<uint8_t>(protocol::camera_algorithm::any);
+  /// Set by `get_detected_objects()`, read by the sampling thread
+  bool volatile m_objects_wanted = false;
+  /// Time since every camera object was last requested
+  vex::timer m_objects_timer;
+  // Uses every member above, so it must be constructed last
+  vex::thread m_sampling_thread;
 };
 /**
  * @brief Constrain a value to the closed interval [min_val, max_val].